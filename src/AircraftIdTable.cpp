@@ -0,0 +1,122 @@
+// AircraftIdTable.cpp
+#include "AircraftIdTable.h"
+#include <cstring>
+
+constexpr uint32_t AircraftIdTable::INVALID_HANDLE;
+constexpr size_t AircraftIdTable::ID_SIZE;
+constexpr uint32_t HandleIndex::NONE;
+
+namespace {
+const size_t INITIAL_BUCKETS = 1024;
+}
+
+AircraftIdTable::AircraftIdTable() : buckets_(INITIAL_BUCKETS, INVALID_HANDLE) {
+    pthread_rwlock_init(&lock_, nullptr);
+}
+
+AircraftIdTable::~AircraftIdTable() {
+    pthread_rwlock_destroy(&lock_);
+}
+
+AircraftIdTable::Key AircraftIdTable::makeKey(const char* id) {
+    Key key;
+    memset(key.bytes, 0, sizeof(key.bytes));
+    strncpy(key.bytes, id, sizeof(key.bytes) - 1);
+    return key;
+}
+
+uint64_t AircraftIdTable::hash(const Key& key) {
+    // Mix the two 8-byte halves (splitmix64 finaliser)
+    uint64_t lo, hi;
+    memcpy(&lo, key.bytes, sizeof(lo));
+    memcpy(&hi, key.bytes + sizeof(lo), sizeof(hi));
+    uint64_t h = lo ^ (hi * 0x9E3779B97F4A7C15ull);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+uint32_t AircraftIdTable::probe(const Key& key, uint64_t h) const {
+    size_t mask = buckets_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        uint32_t handle = buckets_[i];
+        if (handle == INVALID_HANDLE || memcmp(keys_[handle].bytes, key.bytes, sizeof(key.bytes)) == 0) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+}
+
+uint32_t AircraftIdTable::find(const char* id) const {
+    Key key = makeKey(id);
+    uint64_t h = hash(key);
+    pthread_rwlock_rdlock(&lock_);
+    uint32_t handle = buckets_[probe(key, h)];
+    pthread_rwlock_unlock(&lock_);
+    return handle;
+}
+
+uint32_t AircraftIdTable::intern(const char* id) {
+    uint32_t handle = find(id);
+    if (handle != INVALID_HANDLE) {
+        return handle;
+    }
+
+    Key key = makeKey(id);
+    uint64_t h = hash(key);
+    pthread_rwlock_wrlock(&lock_);
+    uint32_t bucket = probe(key, h);
+    handle = buckets_[bucket];
+    if (handle == INVALID_HANDLE) {
+        // Keep the load factor at or below one half
+        if ((keys_.size() + 1) * 2 > buckets_.size()) {
+            grow();
+            bucket = probe(key, h);
+        }
+        handle = static_cast<uint32_t>(keys_.size());
+        keys_.push_back(key);
+        buckets_[bucket] = handle;
+    }
+    pthread_rwlock_unlock(&lock_);
+    return handle;
+}
+
+void AircraftIdTable::grow() {
+    std::vector<uint32_t> buckets(buckets_.size() * 2, INVALID_HANDLE);
+    size_t mask = buckets.size() - 1;
+    for (uint32_t handle = 0; handle < keys_.size(); ++handle) {
+        size_t i = hash(keys_[handle]) & mask;
+        while (buckets[i] != INVALID_HANDLE) {
+            i = (i + 1) & mask;
+        }
+        buckets[i] = handle;
+    }
+    buckets_.swap(buckets);
+}
+
+std::string AircraftIdTable::name(uint32_t handle) const {
+    pthread_rwlock_rdlock(&lock_);
+    std::string result = handle < keys_.size() ? std::string(keys_[handle].bytes) : std::string();
+    pthread_rwlock_unlock(&lock_);
+    return result;
+}
+
+void AircraftIdTable::name(uint32_t handle, char* out) const {
+    pthread_rwlock_rdlock(&lock_);
+    if (handle < keys_.size()) {
+        memcpy(out, keys_[handle].bytes, ID_SIZE);
+    } else {
+        memset(out, 0, ID_SIZE);
+    }
+    pthread_rwlock_unlock(&lock_);
+    out[ID_SIZE - 1] = '\0';
+}
+
+size_t AircraftIdTable::size() const {
+    pthread_rwlock_rdlock(&lock_);
+    size_t result = keys_.size();
+    pthread_rwlock_unlock(&lock_);
+    return result;
+}
@@ -0,0 +1,86 @@
+// AircraftSnapshot.cpp
+#include "AircraftSnapshot.h"
+#include <sched.h>
+
+AircraftSnapshots::Reader::Reader(AircraftSnapshots& snapshots)
+    : snapshots_(snapshots), slot_(snapshots.enter()) {
+    // Loaded after the epoch is announced, see publish()
+    snapshot_ = snapshots_.current_.load();
+}
+
+AircraftSnapshots::Reader::~Reader() {
+    snapshots_.leave(slot_);
+}
+
+AircraftSnapshots::AircraftSnapshots() : current_(new AircraftSnapshot()), epoch_(1) {
+    for (auto& reader : readers_) {
+        reader.epoch.store(IDLE);
+    }
+}
+
+AircraftSnapshots::~AircraftSnapshots() {
+    delete current_.load();
+    for (const auto& retired : retired_) {
+        delete retired.snapshot;
+    }
+    for (AircraftSnapshot* snapshot : free_) {
+        delete snapshot;
+    }
+}
+
+size_t AircraftSnapshots::enter() {
+    while (true) {
+        uint64_t epoch = epoch_.load();
+        for (size_t slot = 0; slot < READER_SLOTS; ++slot) {
+            uint64_t idle = IDLE;
+            if (readers_[slot].epoch.compare_exchange_strong(idle, epoch)) {
+                return slot;
+            }
+        }
+        // More concurrent readers than slots, wait for one to leave
+        sched_yield();
+    }
+}
+
+void AircraftSnapshots::leave(size_t slot) {
+    readers_[slot].epoch.store(IDLE, std::memory_order_release);
+}
+
+AircraftSnapshot* AircraftSnapshots::writable() {
+    reclaim();
+    if (free_.empty()) {
+        return new AircraftSnapshot();
+    }
+    AircraftSnapshot* snapshot = free_.back();
+    free_.pop_back();
+    return snapshot;
+}
+
+void AircraftSnapshots::publish(AircraftSnapshot* snapshot) {
+    AircraftSnapshot* previous = current_.exchange(snapshot);
+    // A reader that announces this epoch or a later one loads its snapshot
+    // after the exchange above, so it can only see the new one
+    uint64_t epoch = epoch_.fetch_add(1) + 1;
+    retired_.push_back({ previous, epoch });
+    reclaim();
+}
+
+void AircraftSnapshots::reclaim() {
+    uint64_t oldest = UINT64_MAX;
+    for (const auto& reader : readers_) {
+        uint64_t epoch = reader.epoch.load();
+        if (epoch != IDLE && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    size_t kept = 0;
+    for (const auto& retired : retired_) {
+        if (retired.epoch <= oldest) {
+            free_.push_back(retired.snapshot);
+        } else {
+            retired_[kept++] = retired;
+        }
+    }
+    retired_.resize(kept);
+}
@@ -0,0 +1,36 @@
+// AircraftSoA.cpp
+#include "AircraftSoA.h"
+
+void AircraftSoA::resize(size_t count) {
+    x_.resize(count);
+    y_.resize(count);
+    z_.resize(count);
+    vx_.resize(count);
+    vy_.resize(count);
+    vz_.resize(count);
+    index_.resize(count);
+}
+
+void AircraftSoA::set(size_t i, const PlaneState& state, uint32_t index) {
+    x_[i] = state.position.x;
+    y_[i] = state.position.y;
+    z_[i] = state.position.z;
+    vx_[i] = state.velocity.x;
+    vy_[i] = state.velocity.y;
+    vz_[i] = state.velocity.z;
+    index_[i] = index;
+}
+
+void AircraftSoA::assign(const std::vector<PlaneState>& states) {
+    resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        set(i, states[i], static_cast<uint32_t>(i));
+    }
+}
+
+void AircraftSoA::assign(const std::vector<PlaneState>& states, const std::vector<uint32_t>& order) {
+    resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        set(i, states[order[i]], order[i]);
+    }
+}
@@ -0,0 +1,63 @@
+// AircraftTransfer.cpp
+#include "AircraftTransfer.h"
+#include "Logger.h"
+#include <sys/neutrino.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Records asked for per chunk by requestAircraftList
+const uint32_t CHUNK_RECORDS = 512;
+}
+
+Status requestAircraftList(int coid, void* msg, size_t msgSize, AircraftListRequest* request,
+                           std::vector<PlaneState>& planes) {
+    AircraftListHeader header;
+    uint32_t frame = 0;
+    uint32_t received = 0;
+
+    while (true) {
+        // Reply records land directly at their final position
+        if (planes.size() < received + CHUNK_RECORDS) {
+            planes.resize(received + CHUNK_RECORDS);
+        }
+        request->offset = received;
+        request->maxRecords = CHUNK_RECORDS;
+
+        iov_t reply[2];
+        SETIOV(&reply[0], &header, sizeof(header));
+        SETIOV(&reply[1], &planes[received], CHUNK_RECORDS * sizeof(PlaneState));
+        if (MsgSendsv(coid, msg, msgSize, reply, 2) == -1) {
+            planes.clear();
+            return Status::ERROR;
+        }
+
+        if (received > 0 && header.frame != frame) {
+            // Snapshot changed under us, start over from the new one
+            received = 0;
+            continue;
+        }
+        frame = header.frame;
+        received += header.count;
+        if (header.count == 0 || received >= header.total) {
+            break;
+        }
+    }
+
+    planes.resize(received);
+    return Status::OK;
+}
+
+int replyAircraftList(int rcvid, const AircraftListRequest& request, uint32_t frame,
+                      const std::vector<PlaneState>& planes) {
+    AircraftListHeader header;
+    header.frame = frame;
+    header.total = static_cast<uint32_t>(planes.size());
+    header.offset = std::min(request.offset, header.total);
+    header.count = std::min(request.maxRecords, header.total - header.offset);
+
+    iov_t iov[2];
+    SETIOV(&iov[0], &header, sizeof(header));
+    SETIOV(&iov[1], planes.data() + header.offset, header.count * sizeof(PlaneState));
+    return MsgReplyv(rcvid, EOK, iov, 2);
+}
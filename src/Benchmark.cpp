@@ -0,0 +1,545 @@
+// Benchmark.cpp
+#include "Benchmark.h"
+#include "ConflictDetector.h"
+#include "ConflictTable.h"
+#include "KdTree.h"
+#include "LogFile.h"
+#include "radar.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Random en-route traffic spread uniformly over the airspace
+std::vector<PlaneState> generateTraffic(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> x(Bounds::MIN_X, Bounds::MAX_X);
+    std::uniform_real_distribution<double> y(Bounds::MIN_Y, Bounds::MAX_Y);
+    std::uniform_real_distribution<double> z(Bounds::MIN_Z, Bounds::MAX_Z);
+    std::uniform_real_distribution<double> speed(-250.0, 250.0);
+    std::uniform_real_distribution<double> climb(-20.0, 20.0);
+
+    std::vector<PlaneState> states(count);
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(states[i].id, sizeof(states[i].id), "B%zu", i);
+        states[i].position = Vector(x(rng), y(rng), z(rng));
+        states[i].velocity = Vector(speed(rng), speed(rng), climb(rng));
+        states[i].coid_comp = -1;
+    }
+    return states;
+}
+
+// Arrival traffic: aircraft strung along eight approach corridors that
+// converge on an airport in the middle of the airspace, descending as they close in
+std::vector<PlaneState> generateCorridorTraffic(size_t count, unsigned seed) {
+    const int CORRIDORS = 8;
+    const double PI = 3.14159265358979323846;
+    const double centerX = 0.5 * (Bounds::MIN_X + Bounds::MAX_X);
+    const double centerY = 0.5 * (Bounds::MIN_Y + Bounds::MAX_Y);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> distance(5000.0, 50000.0);
+    std::uniform_real_distribution<double> lateral(-1500.0, 1500.0);
+    std::uniform_real_distribution<double> level(-500.0, 500.0);
+    std::uniform_real_distribution<double> speed(120.0, 180.0);
+    std::uniform_real_distribution<double> drift(-5.0, 5.0);
+
+    std::vector<PlaneState> states(count);
+    for (size_t i = 0; i < count; ++i) {
+        double angle = 2.0 * PI * (i % CORRIDORS) / CORRIDORS;
+        double dx = std::cos(angle);
+        double dy = std::sin(angle);
+        double d = distance(rng);
+        double offset = lateral(rng);
+        double v = speed(rng);
+        snprintf(states[i].id, sizeof(states[i].id), "C%zu", i);
+        states[i].position = Vector(centerX + dx * d - dy * offset, centerY + dy * d + dx * offset,
+                                    std::min(1000.0 + 0.4 * d + level(rng), Bounds::MAX_Z));
+        states[i].velocity = Vector(-dx * v + drift(rng), -dy * v + drift(rng), -0.05 * v);
+        states[i].coid_comp = -1;
+    }
+    return states;
+}
+
+const char* broadPhaseName(BroadPhase broadPhase) {
+    switch (broadPhase) {
+        case BroadPhase::BRUTE_FORCE: return "brute force";
+        case BroadPhase::SPATIAL_GRID: return "spatial grid";
+        case BroadPhase::SWEEP_AND_PRUNE: return "sweep and prune";
+        case BroadPhase::TIME_SLICED: return "time-sliced";
+    }
+    return "unknown";
+}
+
+// Average milliseconds per detection over 'runs' runs, after one warm-up run
+double timeDetection(ConflictDetector& detector, const std::vector<PlaneState>& states,
+                     double lookahead, int runs, size_t& conflictCount) {
+    std::vector<Conflict> conflicts;
+    detector.detect(states, lookahead, conflicts);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r) {
+        detector.detect(states, lookahead, conflicts);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    conflictCount = conflicts.size();
+    return std::chrono::duration<double, std::milli>(elapsed).count() / runs;
+}
+
+// Average milliseconds per detection over 'frames' consecutive one-second
+// frames, so broad phases that keep state between checks see aircraft move
+double timeFrames(ConflictDetector& detector, std::vector<PlaneState> states,
+                  double lookahead, int frames, size_t& conflictCount) {
+    std::vector<Conflict> conflicts;
+    detector.detect(states, lookahead, conflicts);
+
+    double total = 0.0;
+    for (int f = 0; f < frames; ++f) {
+        for (auto& s : states) {
+            s.position.x += s.velocity.x;
+            s.position.y += s.velocity.y;
+            s.position.z += s.velocity.z;
+        }
+        auto start = std::chrono::steady_clock::now();
+        detector.detect(states, lookahead, conflicts);
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    conflictCount = conflicts.size();
+    return total / frames;
+}
+
+const BroadPhase BROAD_PHASES[] = { BroadPhase::BRUTE_FORCE, BroadPhase::SPATIAL_GRID, BroadPhase::SWEEP_AND_PRUNE,
+                                     BroadPhase::TIME_SLICED };
+const size_t BROAD_PHASE_COUNT = sizeof(BROAD_PHASES) / sizeof(BROAD_PHASES[0]);
+
+// Steps one detector per broad phase through the same one-second frames and
+// counts, per broad phase, the frames whose conflicts differ from brute force
+void countBroadPhaseMismatches(std::vector<PlaneState> states, double lookahead, int frames,
+                               size_t mismatches[BROAD_PHASE_COUNT]) {
+    ConflictDetector detectors[BROAD_PHASE_COUNT];
+    std::vector<Conflict> conflicts[BROAD_PHASE_COUNT];
+    for (size_t p = 0; p < BROAD_PHASE_COUNT; ++p) {
+        detectors[p].setWorkerCount(1);
+        detectors[p].setBroadPhase(BROAD_PHASES[p]);
+        mismatches[p] = 0;
+    }
+    for (int f = 0; f <= frames; ++f) {
+        for (size_t p = 0; p < BROAD_PHASE_COUNT; ++p) {
+            detectors[p].detect(states, lookahead, conflicts[p]);
+            if (!ConflictDetector::samePairs(conflicts[0], conflicts[p])) {
+                ++mismatches[p];
+            }
+        }
+        for (auto& s : states) {
+            s.position.x += s.velocity.x;
+            s.position.y += s.velocity.y;
+            s.position.z += s.velocity.z;
+        }
+    }
+}
+
+// Returns the number of frames on which a broad phase disagreed with brute force
+size_t runBroadPhaseComparison(double lookahead) {
+    const size_t SIZES[] = { 1000, 10000 };
+    const int FRAMES = 10;
+
+    ConflictDetector detector;
+    detector.setWorkerCount(1);
+    printf("\nBroad phase comparison (1 worker, lookahead %.0fs, %d one-second frames)\n", lookahead, FRAMES);
+    printf("%10s %10s %16s %12s %10s %18s\n", "traffic", "aircraft", "broad phase", "ms/check", "conflicts",
+           "frames != brute");
+
+    size_t totalMismatches = 0;
+    for (int clustered = 0; clustered <= 1; ++clustered) {
+        for (size_t count : SIZES) {
+            std::vector<PlaneState> states = clustered ? generateCorridorTraffic(count, 42) : generateTraffic(count, 42);
+            size_t mismatches[BROAD_PHASE_COUNT];
+            countBroadPhaseMismatches(states, lookahead, FRAMES, mismatches);
+            for (size_t p = 0; p < BROAD_PHASE_COUNT; ++p) {
+                detector.setBroadPhase(BROAD_PHASES[p]);
+                size_t conflicts = 0;
+                double ms = timeFrames(detector, states, lookahead, FRAMES, conflicts);
+                printf("%10s %10zu %16s %12.3f %10zu %18zu\n", clustered ? "corridors" : "uniform", count,
+                       broadPhaseName(BROAD_PHASES[p]), ms, conflicts, mismatches[p]);
+                totalMismatches += mismatches[p];
+            }
+        }
+    }
+    if (totalMismatches > 0) {
+        printf("FAILED: broad phases disagree with brute force on %zu frames\n", totalMismatches);
+    }
+    return totalMismatches;
+}
+
+// What the advisory and strategic tiers cost with each broad phase, one
+// check per horizon; returns the number of checks that differ from brute force
+size_t runLongHorizonComparison() {
+    const size_t COUNT = 10000;
+    const double HORIZONS[] = { 60.0, 600.0 };
+
+    printf("\nLong lookahead horizons (%zu aircraft, 1 worker)\n", COUNT);
+    printf("%10s %10s %16s %12s %10s %10s\n", "traffic", "horizon", "broad phase", "ms/check", "conflicts",
+           "!= brute");
+
+    ConflictDetector detector;
+    detector.setWorkerCount(1);
+    std::vector<Conflict> reference, conflicts;
+    size_t mismatches = 0;
+    for (int clustered = 0; clustered <= 1; ++clustered) {
+        std::vector<PlaneState> states = clustered ? generateCorridorTraffic(COUNT, 42) : generateTraffic(COUNT, 42);
+        for (double horizon : HORIZONS) {
+            detector.setBroadPhase(BroadPhase::BRUTE_FORCE);
+            detector.detect(states, horizon, reference);
+            for (BroadPhase broadPhase : BROAD_PHASES) {
+                detector.setBroadPhase(broadPhase);
+                size_t count = 0;
+                double ms = timeDetection(detector, states, horizon, 1, count);
+                detector.detect(states, horizon, conflicts);
+                bool differs = !ConflictDetector::samePairs(reference, conflicts);
+                mismatches += differs ? 1 : 0;
+                printf("%10s %10.0f %16s %12.3f %10zu %10s\n", clustered ? "corridors" : "uniform", horizon,
+                       broadPhaseName(broadPhase), ms, count, differs ? "yes" : "no");
+            }
+        }
+    }
+    if (mismatches > 0) {
+        printf("FAILED: %zu long-horizon checks disagree with brute force\n", mismatches);
+    }
+    return mismatches;
+}
+
+const int VALIDATION_FRAMES = 200;
+
+// Moves 'snapshot' on by one radar frame of one second the way the radar
+// decoder does: straight-line motion, some aircraft changing course in a
+// step, one aircraft replaced by a new one, and a keyframe now and then.
+// With a non-zero 'acceleration' some aircraft also turn gently, within it.
+void advanceFrame(AircraftSnapshot& snapshot, int frame, double acceleration, std::mt19937& rng,
+                  uint32_t& nextHandle) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_real_distribution<double> speed(-250.0, 250.0);
+    std::uniform_real_distribution<double> climb(-20.0, 20.0);
+    // Per axis, so the whole change stays below 'acceleration' over the second
+    std::uniform_real_distribution<double> turn(-0.5 * acceleration, 0.5 * acceleration);
+    std::vector<PlaneState>& states = snapshot.states;
+    snapshot.touched.clear();
+    snapshot.dropped.clear();
+    snapshot.time += 1.0;
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        PlaneState& s = states[i];
+        s.position.x += s.velocity.x;
+        s.position.y += s.velocity.y;
+        s.position.z += s.velocity.z;
+        if (unit(rng) < 0.01) {
+            s.velocity = Vector(speed(rng), speed(rng), climb(rng));
+            snapshot.touched.push_back(snapshot.handles[i]);
+        } else if (acceleration > 0.0 && unit(rng) < 0.05) {
+            s.velocity.x += turn(rng);
+            s.velocity.y += turn(rng);
+            s.velocity.z += 0.1 * turn(rng);
+            snapshot.touched.push_back(snapshot.handles[i]);
+        }
+    }
+
+    if (frame % 7 == 0) {
+        size_t i = rng() % states.size();
+        snapshot.dropped.push_back(snapshot.handles[i]);
+        std::vector<PlaneState> arrival = generateTraffic(1, rng());
+        snprintf(arrival[0].id, sizeof(arrival[0].id), "N%u", nextHandle);
+        states[i] = arrival[0];
+        snapshot.handles[i] = nextHandle;
+        snapshot.touched.push_back(nextHandle++);
+    }
+    if (frame % 50 == 0) {
+        snapshot.touched = snapshot.handles;
+    }
+
+    snapshot.index.clear();
+    for (size_t i = 0; i < snapshot.handles.size(); ++i) {
+        snapshot.index.set(snapshot.handles[i], static_cast<uint32_t>(i));
+    }
+}
+
+// Runs the incremental conflict table and a full detection side by side over
+// moving frames, with aircraft turning at up to 'turning' units/s^2, and the
+// table assuming 'maxAcceleration'; returns the number of frames on which
+// they disagree
+size_t runIncrementalValidation(size_t count, double lookahead, double turning, double maxAcceleration) {
+    const int FRAMES = VALIDATION_FRAMES;
+
+    AircraftSnapshot snapshot;
+    snapshot.states = generateTraffic(count, 7);
+    for (uint32_t i = 0; i < count; ++i) {
+        snapshot.handles.push_back(i);
+        snapshot.touched.push_back(i);
+        snapshot.index.set(i, i);
+    }
+    uint32_t nextHandle = static_cast<uint32_t>(count);
+    std::mt19937 rng(7);
+
+    ConflictTable table;
+    table.setMaxAcceleration(maxAcceleration);
+    ConflictDetector detector;
+    detector.setWorkerCount(1);
+    std::vector<Conflict> incremental, full;
+    double incrementalMs = 0.0, fullMs = 0.0;
+    size_t mismatches = 0;
+    size_t deviated = 0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        if (frame > 0) {
+            advanceFrame(snapshot, frame, turning, rng, nextHandle);
+        }
+        auto start = std::chrono::steady_clock::now();
+        table.update(snapshot, lookahead, incremental);
+        auto updated = std::chrono::steady_clock::now();
+        detector.detect(snapshot.states, lookahead, full);
+        auto detected = std::chrono::steady_clock::now();
+        if (frame > 0) {
+            incrementalMs += std::chrono::duration<double, std::milli>(updated - start).count();
+            fullMs += std::chrono::duration<double, std::milli>(detected - updated).count();
+        }
+        if (!ConflictDetector::samePairs(full, incremental)) {
+            ++mismatches;
+        }
+        deviated += table.getStats().deviatedAircraft;
+    }
+    printf("%10zu %10.0f %10.1f %12.1f %12zu %12.3f %12.3f %12zu\n", count, lookahead, turning, maxAcceleration,
+           deviated, incrementalMs / (FRAMES - 1), fullMs / (FRAMES - 1), mismatches);
+    return mismatches;
+}
+
+enum class QueryKind { RADIUS, BOX, NEAREST };
+
+double distance2(const PlaneState& state, const Vector& point) {
+    double dx = state.position.x - point.x;
+    double dy = state.position.y - point.y;
+    double dz = state.position.z - point.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Reference for the k-d tree: every aircraft is tested, nearest ones are ranked
+void scanQuery(const std::vector<PlaneState>& states, QueryKind query, const Vector& point,
+               const Vector& high, double radius, size_t k, std::vector<uint32_t>& out) {
+    out.clear();
+    if (query == QueryKind::NEAREST) {
+        std::vector<std::pair<double, uint32_t>> ranked(states.size());
+        for (uint32_t i = 0; i < states.size(); ++i) {
+            ranked[i] = { distance2(states[i], point), i };
+        }
+        k = std::min(k, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + k, ranked.end());
+        for (size_t i = 0; i < k; ++i) {
+            out.push_back(ranked[i].second);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < states.size(); ++i) {
+        const Vector& p = states[i].position;
+        bool hit = query == QueryKind::RADIUS
+            ? distance2(states[i], point) <= radius * radius
+            : p.x >= point.x && p.x <= high.x && p.y >= point.y && p.y <= high.y && p.z >= point.z && p.z <= high.z;
+        if (hit) {
+            out.push_back(i);
+        }
+    }
+}
+
+// Nearest results may order equally distant aircraft either way, so they are
+// compared by distance; the others as sets
+bool sameHits(const std::vector<PlaneState>& states, QueryKind query, const Vector& point,
+              std::vector<uint32_t>& hits, std::vector<uint32_t>& expected) {
+    if (hits.size() != expected.size()) {
+        return false;
+    }
+    if (query == QueryKind::NEAREST) {
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (distance2(states[hits[i]], point) != distance2(states[expected[i]], point)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::sort(hits.begin(), hits.end());
+    std::sort(expected.begin(), expected.end());
+    return hits == expected;
+}
+
+// Times k-d tree radius, box and nearest queries over random points against a
+// scan of every aircraft; returns the number of queries whose results differ
+size_t runSpatialQueryBenchmark(size_t count) {
+    const int QUERIES = 1000;
+    const double RADIUS = 5000.0;
+    const Vector BOX(10000.0, 10000.0, 2500.0);
+    const size_t NEAREST = 10;
+    const QueryKind QUERY_KINDS[] = { QueryKind::RADIUS, QueryKind::BOX, QueryKind::NEAREST };
+    const char* QUERY_NAMES[] = { "radius", "box", "nearest" };
+
+    std::vector<PlaneState> states = generateTraffic(count, 42);
+    KdTree tree;
+    auto start = std::chrono::steady_clock::now();
+    tree.build(states);
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> x(Bounds::MIN_X, Bounds::MAX_X);
+    std::uniform_real_distribution<double> y(Bounds::MIN_Y, Bounds::MAX_Y);
+    std::uniform_real_distribution<double> z(Bounds::MIN_Z, Bounds::MAX_Z);
+    std::vector<Vector> points(QUERIES);
+    for (auto& point : points) {
+        point = Vector(x(rng), y(rng), z(rng));
+    }
+
+    printf("\nk-d tree queries (%zu aircraft, build %.3f ms, %d queries each, radius %.0f, box %.0fx%.0fx%.0f, k %zu)\n",
+           count, buildMs, QUERIES, RADIUS, BOX.x, BOX.y, BOX.z, NEAREST);
+    printf("%10s %12s %12s %10s %10s %12s\n", "query", "us/query", "scan us", "speedup", "mean hits", "mismatches");
+
+    std::vector<uint32_t> hits, expected;
+    std::vector<KdTree::Candidate> heap;
+    size_t totalMismatches = 0;
+    for (size_t q = 0; q < sizeof(QUERY_KINDS) / sizeof(QUERY_KINDS[0]); ++q) {
+        QueryKind query = QUERY_KINDS[q];
+        double treeUs = 0.0, scanUs = 0.0;
+        size_t hitCount = 0, mismatches = 0;
+        for (const Vector& point : points) {
+            Vector high(point.x + BOX.x, point.y + BOX.y, point.z + BOX.z);
+            auto queryStart = std::chrono::steady_clock::now();
+            if (query == QueryKind::RADIUS) {
+                tree.withinRadius(point, RADIUS, hits);
+            } else if (query == QueryKind::BOX) {
+                tree.withinBox(point, high, hits);
+            } else {
+                tree.nearest(point, NEAREST, hits, heap);
+            }
+            auto queried = std::chrono::steady_clock::now();
+            scanQuery(states, query, point, high, RADIUS, NEAREST, expected);
+            auto scanned = std::chrono::steady_clock::now();
+            treeUs += std::chrono::duration<double, std::micro>(queried - queryStart).count();
+            scanUs += std::chrono::duration<double, std::micro>(scanned - queried).count();
+
+            hitCount += hits.size();
+            if (!sameHits(states, query, point, hits, expected)) {
+                ++mismatches;
+            }
+        }
+        printf("%10s %12.3f %12.3f %9.1fx %10.1f %12zu\n", QUERY_NAMES[q], treeUs / QUERIES, scanUs / QUERIES,
+               scanUs / treeUs, static_cast<double>(hitCount) / QUERIES, mismatches);
+        totalMismatches += mismatches;
+    }
+    if (totalMismatches > 0) {
+        printf("FAILED: k-d tree queries disagree with a full scan on %zu queries\n", totalMismatches);
+    }
+    return totalMismatches;
+}
+
+} // namespace
+
+int runDetectionBenchmark() {
+    const double LOOKAHEAD = 3.0;
+    const size_t SIZES[] = { 1000, 10000, 50000 };
+    size_t maxWorkers = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+    ConflictDetector detector;
+    printf("Conflict detection scaling (spatial grid, %s kernel, lookahead %.0fs)\n",
+           kernelIsaName(detector.getKernelIsa()), LOOKAHEAD);
+    printf("%10s %8s %12s %10s %10s\n", "aircraft", "workers", "ms/check", "speedup", "conflicts");
+
+    for (size_t count : SIZES) {
+        std::vector<PlaneState> states = generateTraffic(count, 42);
+        int runs = count >= 50000 ? 3 : 10;
+        double baseline = 0.0;
+        for (size_t workers = 1; workers <= maxWorkers; ++workers) {
+            detector.setWorkerCount(workers);
+            size_t conflicts = 0;
+            double ms = timeDetection(detector, states, LOOKAHEAD, runs, conflicts);
+            if (workers == 1) {
+                baseline = ms;
+            }
+            printf("%10zu %8zu %12.3f %9.2fx %10zu\n", count, workers, ms, baseline / ms, conflicts);
+        }
+    }
+
+    size_t mismatches = runBroadPhaseComparison(LOOKAHEAD) + runLongHorizonComparison();
+
+    printf("\nIncremental conflict table against full detection (%d one-second frames)\n", VALIDATION_FRAMES);
+    printf("%10s %10s %10s %12s %12s %12s %12s %12s\n", "aircraft", "lookahead", "turning", "accel bound",
+           "deviated", "ms/frame", "full ms", "mismatches");
+    // Each turning row is run twice: once with the bound, once re-checking
+    // every pair of a turning aircraft as if there were none
+    size_t incrementalMismatches = runIncrementalValidation(5000, LOOKAHEAD, 0.0, 0.0)
+                                   + runIncrementalValidation(5000, LOOKAHEAD, 5.0, 5.0)
+                                   + runIncrementalValidation(5000, LOOKAHEAD, 5.0, 0.0)
+                                   + runIncrementalValidation(1000, 60.0, 0.0, 0.0)
+                                   + runIncrementalValidation(1000, 60.0, 5.0, 5.0)
+                                   + runIncrementalValidation(1000, 60.0, 5.0, 0.0);
+    if (incrementalMismatches > 0) {
+        printf("FAILED: the incremental table disagrees with full detection on %zu frames\n", incrementalMismatches);
+    }
+
+    size_t queryMismatches = runSpatialQueryBenchmark(50000);
+    return mismatches + incrementalMismatches + queryMismatches > 0 ? 1 : 0;
+}
+
+int runLoggingBenchmark() {
+    const char* PATH = "benchmark-log.txt";
+    const size_t ROTATE_BYTES = 16 * 1024 * 1024;
+    const size_t TOTAL_BYTES = 256 * 1024 * 1024;
+    const size_t OPEN_PER_LINE = 2000;
+
+    // Lines shaped like the airspace state dump
+    std::vector<std::string> lines;
+    for (const auto& state : generateTraffic(10000, 42)) {
+        char line[160];
+        snprintf(line, sizeof(line), "12:00:00.000[LOG] Aircraft ID: %s Position: (%.2f, %.2f, %.2f) Velocity: (%.2f, %.2f, %.2f)\n",
+                 state.id, state.position.x, state.position.y, state.position.z,
+                 state.velocity.x, state.velocity.y, state.velocity.z);
+        lines.push_back(line);
+    }
+
+    printf("\nLog file throughput\n");
+    printf("%-28s %10s %12s %10s %10s\n", "sink", "MB", "lines/s", "MB/s", "rotations");
+
+    // What LOG_TO_FILE used to do for every line
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < OPEN_PER_LINE; ++i) {
+        std::ofstream file(PATH, std::ios::app);
+        file << lines[i % lines.size()] << std::flush;
+        bytes += lines[i % lines.size()].size();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-28s %10.1f %12.0f %10.1f %10d\n", "open, append, close", bytes / 1e6, OPEN_PER_LINE / seconds,
+           bytes / seconds / 1e6, 0);
+    unlink(PATH);
+
+    LogFile file;
+    if (file.open(PATH, ROTATE_BYTES, 2) != Status::OK) {
+        printf("Failed to open %s\n", PATH);
+        return -1;
+    }
+    size_t written = 0;
+    bytes = 0;
+    start = std::chrono::steady_clock::now();
+    while (bytes < TOTAL_BYTES) {
+        const std::string& line = lines[written++ % lines.size()];
+        file.append(line.data(), line.size());
+        bytes += line.size();
+    }
+    file.close();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const LogFileStats& stats = file.getStats();
+    printf("%-28s %10.1f %12.0f %10.1f %10llu\n", "buffered, rotating", bytes / 1e6, written / seconds,
+           bytes / seconds / 1e6, static_cast<unsigned long long>(stats.rotations));
+    printf("%-28s %10.1f %12s %10.1f %10s\n", "  (inside write() only)", stats.bytes / 1e6, "",
+           stats.mbPerSecond(), "");
+
+    unlink(PATH);
+    unlink((std::string(PATH) + ".1").c_str());
+    unlink((std::string(PATH) + ".2").c_str());
+    return 0;
+}
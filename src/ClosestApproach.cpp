@@ -0,0 +1,85 @@
+// ClosestApproach.cpp
+#include "ClosestApproach.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool conflictWindow(double px, double py, double pz, double vx, double vy, double vz,
+                    double lookahead, double& enter, double& exit) {
+    return conflictWindow(px, py, pz, vx, vy, vz, lookahead, Separation::HORIZONTAL, Separation::VERTICAL,
+                          enter, exit);
+}
+
+bool conflictWindow(double px, double py, double pz, double vx, double vy, double vz,
+                    double lookahead, double H, double V, double& enter, double& exit) {
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // Horizontal: |p + v t|^2 < H^2  <=>  qa t^2 + 2 qb t + qc < 0
+    double qa = vx * vx + vy * vy;
+    double qb = px * vx + py * vy;
+    double qc = px * px + py * py - H * H;
+    double hEnter, hExit;
+    if (qa == 0.0) {
+        hEnter = (qc < 0.0) ? -INF : INF;
+        hExit = (qc < 0.0) ? INF : -INF;
+    } else {
+        double disc = qb * qb - qa * qc;
+        if (disc <= 0.0) {
+            hEnter = INF;
+            hExit = -INF;
+        } else {
+            double root = std::sqrt(disc);
+            hEnter = (-qb - root) / qa;
+            hExit = (-qb + root) / qa;
+        }
+    }
+
+    // Vertical: |pz + vz t| < V
+    double vEnter, vExit;
+    if (vz == 0.0) {
+        bool inside = std::fabs(pz) < V;
+        vEnter = inside ? -INF : INF;
+        vExit = inside ? INF : -INF;
+    } else {
+        double t0 = (-V - pz) / vz;
+        double t1 = (V - pz) / vz;
+        vEnter = std::min(t0, t1);
+        vExit = std::max(t0, t1);
+    }
+
+    enter = std::max(0.0, std::max(hEnter, vEnter));
+    exit = std::min(lookahead, std::min(hExit, vExit));
+    return enter < exit;
+}
+
+ClosestApproach computeClosestApproach(const PlaneState& a, const PlaneState& b, double lookahead) {
+    // Relative motion of b seen from a
+    double px = b.position.x - a.position.x;
+    double py = b.position.y - a.position.y;
+    double pz = b.position.z - a.position.z;
+    double vx = b.velocity.x - a.velocity.x;
+    double vy = b.velocity.y - a.velocity.y;
+    double vz = b.velocity.z - a.velocity.z;
+
+    double enter, exit;
+    ClosestApproach result;
+    result.conflict = conflictWindow(px, py, pz, vx, vy, vz, lookahead, enter, exit);
+    result.timeToConflict = result.conflict ? enter : -1.0;
+
+    double qa = vx * vx + vy * vy;
+    double qb = px * vx + py * vy;
+    result.time = (qa == 0.0) ? 0.0 : std::min(std::max(-qb / qa, 0.0), lookahead);
+    double hx = px + vx * result.time;
+    double hy = py + vy * result.time;
+    result.horizontalDistance = std::sqrt(hx * hx + hy * hy);
+    result.verticalDistance = std::fabs(pz + vz * result.time);
+    return result;
+}
+
+void computeClosestApproach(const PlaneState* states, const CandidatePair* pairs, size_t count,
+                            double lookahead, ClosestApproach* results) {
+    for (size_t k = 0; k < count; ++k) {
+        results[k] = computeClosestApproach(states[pairs[k].first], states[pairs[k].second], lookahead);
+    }
+}
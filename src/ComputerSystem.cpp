@@ -8,11 +8,25 @@
 #include <iostream>
 #include <cstring>
 #include <cmath>
+#include <algorithm>
 #include <errno.h>
+#include <time.h>
 #include "Logger.h"
-
-ComputerSystem::ComputerSystem() : running_(false), lookaheadTime_(3) { // Default 'n' is 180 seconds
+#include "Timestamp.h"
+#include "AircraftTransfer.h"
+
+ComputerSystem::ComputerSystem()
+    : running_(false), frame_(0), frameTime_(0.0),
+      tierConfig_(LookaheadTiers::defaults(3.0)), tiersChanged_(false),
+      broadPhase_(BroadPhase::SPATIAL_GRID), broadPhaseCrossCheck_(false),
+      workerCount_(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN))),
+      incrementalDetection_(false), incrementalValidation_(false), maxAcceleration_(0.0), alertTracking_(true),
+      publishedFrame_(0), checkedFrame_(0), frameArrivalNs_(0),
+      alertTier_(LookaheadTiers::emptyStats(tierConfig_.front())) {
     pthread_mutex_init(&data_mutex_, nullptr);
+    pthread_mutex_init(&frame_mutex_, nullptr);
+    pthread_cond_init(&frameReady_, nullptr);
+    pthread_cond_init(&frameChecked_, nullptr);
 
     // Create channels for receiving messages
     radar_chid_ = ChannelCreate(0);
@@ -41,11 +55,15 @@ ComputerSystem::ComputerSystem() : running_(false), lookaheadTime_(3) { // Defau
 
 ComputerSystem::~ComputerSystem() {
     stop();
+    pthread_cond_destroy(&frameChecked_);
+    pthread_cond_destroy(&frameReady_);
+    pthread_mutex_destroy(&frame_mutex_);
     pthread_mutex_destroy(&data_mutex_);
 }
 
 void ComputerSystem::start() {
     running_ = true;
+    LOG_INFO("ComputerSystem", std::string("Separation kernel: ") + kernelIsaName(detector_.getKernelIsa()));
     int ret = pthread_create(&thread_, nullptr, ComputerSystem::threadFunc, this);
     if (ret != 0) {
       LOG_ERROR("ComputerSystem", "Failed to create main thread");
@@ -53,6 +71,14 @@ void ComputerSystem::start() {
     }
     LOG_INFO("ComputerSystem", "Main thread started");
 
+    // Start the lookahead tier thread
+    ret = pthread_create(&tier_thread_, nullptr, ComputerSystem::tierThreadFunc, this);
+    if (ret != 0) {
+        LOG_ERROR("ComputerSystem", "Failed to create lookahead tier thread");
+        exit(EXIT_FAILURE);
+    }
+    LOG_INFO("ComputerSystem", "Lookahead tier thread started");
+
     // Start radar thread
     ret = pthread_create(&radar_thread_, nullptr, ComputerSystem::radarThreadFunc, this);
     if (ret != 0) {
@@ -92,12 +118,19 @@ void ComputerSystem::stop() {
         int priority = param.sched_priority;
     	airspaceLogTimer->stop();
 
+        // Wake the checker, the tier thread and a radar reply waiting on them
+        pthread_mutex_lock(&frame_mutex_);
+        pthread_cond_broadcast(&frameReady_);
+        pthread_cond_broadcast(&frameChecked_);
+        pthread_mutex_unlock(&frame_mutex_);
+
         //destroy channels
         ChannelDestroy(radar_chid_);
         ChannelDestroy(operator_chid_);
         ChannelDestroy(dataDisplay_chid_);
 
         pthread_join(thread_, nullptr);
+        pthread_join(tier_thread_, nullptr);
         pthread_join(radar_thread_, nullptr);
         pthread_join(operator_thread_, nullptr);
         pthread_join(dataDisplay_thread_, nullptr);
@@ -128,21 +161,102 @@ void* ComputerSystem::dataDisplayThreadFunc(void* arg) {
     return nullptr;
 }
 
+void* ComputerSystem::tierThreadFunc(void* arg) {
+    ComputerSystem* self = static_cast<ComputerSystem*>(arg);
+    self->tierLoop();
+    return nullptr;
+}
+
 void ComputerSystem::run() {
-    while (running_) {
-        // Perform separation checks
-        checkForViolations();
+    while (true) {
+        // Sleep until the radar thread publishes a frame we have not checked
+        pthread_mutex_lock(&frame_mutex_);
+        while (running_ && publishedFrame_ == checkedFrame_) {
+            pthread_cond_wait(&frameReady_, &frame_mutex_);
+        }
+        if (!running_) {
+            pthread_mutex_unlock(&frame_mutex_);
+            break;
+        }
+        uint32_t frame = publishedFrame_;
+        uint64_t arrival = frameArrivalNs_;
+        pthread_mutex_unlock(&frame_mutex_);
+
+        uint64_t start = Timestamp::monotonicNanos();
+        size_t alerts = checkForViolations();
+        uint64_t checked = Timestamp::monotonicNanos();
+        double latencyMs = (checked - arrival) / 1e6;
+
+        pthread_mutex_lock(&frame_mutex_);
+        checkedFrame_ = frame;
+        LookaheadTiers::record(alertTier_, alerts, (checked - start) / 1e6);
+        ++latency_.frames;
+        latency_.alerts += alerts;
+        latency_.lastMs = latencyMs;
+        latency_.meanMs += (latencyMs - latency_.meanMs) / latency_.frames;
+        latency_.maxMs = std::max(latency_.maxMs, latencyMs);
+        alertStats_ = alerts_.getStats();
+        // Releases the radar reply and wakes the tier thread
+        pthread_cond_broadcast(&frameChecked_);
+        pthread_mutex_unlock(&frame_mutex_);
+    }
+}
 
-        // Sleep for a short duration before next cycle
-        usleep(100000); // 100 ms
+void ComputerSystem::tierLoop() {
+    // One step below the checker, so a due advisory or strategic check only
+    // gets the time the checker, radar and clock leave idle. Its worker pool
+    // is created from this thread and inherits the priority.
+    struct sched_param param;
+    int policy;
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    param.sched_priority = std::max(sched_get_priority_min(policy), param.sched_priority - 1);
+    pthread_setschedparam(pthread_self(), policy, &param);
+
+    uint32_t lastFrame = 0;
+    while (true) {
+        // Sleep until the checker finishes a frame; frames checked while a
+        // long tier ran are caught up in one pass
+        pthread_mutex_lock(&frame_mutex_);
+        while (running_ && checkedFrame_ == lastFrame) {
+            pthread_cond_wait(&frameChecked_, &frame_mutex_);
+        }
+        if (!running_) {
+            pthread_mutex_unlock(&frame_mutex_);
+            break;
+        }
+        uint32_t frame = checkedFrame_;
+        pthread_mutex_unlock(&frame_mutex_);
+
+        pthread_mutex_lock(&data_mutex_);
+        if (tiersChanged_) {
+            tiers_.configure(tierConfig_);
+            tiersChanged_ = false;
+        }
+        size_t workerCount = workerCount_;
+        pthread_mutex_unlock(&data_mutex_);
+        tiers_.setWorkerCount(workerCount);
+
+        {
+            // The latest published snapshot, possibly a frame or two past 'frame'
+            AircraftSnapshots::Reader snapshot(snapshots_);
+            tiers_.checkLongerTiers(lastFrame, frame, snapshot->states);
+        }
+        lastFrame = frame;
+
+        pthread_mutex_lock(&frame_mutex_);
+        tierStats_ = tiers_.getStats();
+        pthread_mutex_unlock(&frame_mutex_);
     }
 }
 
 void ComputerSystem::radarLoop() {
     while (running_) {
-        // Prepare to receive the maximum possible message size
-        char msg_buffer[sizeof(RadarToComputerMsg)];
-        int rcvid = MsgReceive(radar_chid_, &msg_buffer, sizeof(msg_buffer), NULL);
+        // Only the header is received here, the records are pulled with MsgRead
+        union {
+            struct _pulse pulse;
+            RadarFrameHeader header;
+        } msg;
+        int rcvid = MsgReceive(radar_chid_, &msg, sizeof(msg), NULL);
         if (rcvid == -1) {
             if (errno == EINTR) {
                 continue;
@@ -152,15 +266,45 @@ void ComputerSystem::radarLoop() {
             }
         }
         if (rcvid == 0) {
-            struct _pulse* pulse = (struct _pulse*)&msg_buffer;
-            if (pulse->code == PULSE_CODE_EXIT) {
+            if (msg.pulse.code == PULSE_CODE_EXIT) {
                 break;
             }
         } else if (rcvid > 0) {
-            RadarToComputerMsg* radarMsg = (RadarToComputerMsg*)&msg_buffer;
-            pthread_mutex_lock(&data_mutex_);
-            aircraftStates_.assign(radarMsg->aircraftData, radarMsg->aircraftData + radarMsg->numAircraft);
-            pthread_mutex_unlock(&data_mutex_);
+            uint64_t arrival = Timestamp::monotonicNanos();
+            // aircraftStates_ belongs to this thread, readers only see published snapshots
+            Status status = radarDecoder_.apply(rcvid, msg.header, aircraftStates_);
+            if (status == Status::ERROR) {
+                LOG_ERROR("ComputerSystem", "Failed to read radar frame");
+                MsgError(rcvid, EIO);
+                continue;
+            }
+            for (uint32_t handle : radarDecoder_.getDropped()) {
+                corrections_.invalidate(handle);
+            }
+            frameTime_ += msg.header.dt;
+            AircraftSnapshot* snapshot = snapshots_.writable();
+            snapshot->frame = ++frame_;
+            snapshot->time = frameTime_;
+            snapshot->states = aircraftStates_;
+            snapshot->handles = radarDecoder_.getTracks();
+            snapshot->index = radarDecoder_.getIndex();
+            snapshot->touched = radarDecoder_.getTouched();
+            snapshot->dropped = radarDecoder_.getDropped();
+            snapshot->spatialIndex.build(snapshot->states);
+            snapshots_.publish(snapshot);
+
+            // Hand the frame to the checker and hold the reply until it has
+            // been checked: every frame is checked exactly once, the radar
+            // cannot outrun the checker, and corrections land before the
+            // simulation clock moves to the next tick
+            pthread_mutex_lock(&frame_mutex_);
+            publishedFrame_ = frame_;
+            frameArrivalNs_ = arrival;
+            pthread_cond_signal(&frameReady_);
+            while (running_ && checkedFrame_ != frame_) {
+                pthread_cond_wait(&frameChecked_, &frame_mutex_);
+            }
+            pthread_mutex_unlock(&frame_mutex_);
             MsgReply(rcvid, EOK, nullptr, 0);
 
         }
@@ -188,33 +332,33 @@ void ComputerSystem::operatorLoop() {
         OperatorCommandMsg* msg = (OperatorCommandMsg*)&msg_buffer;
         switch(msg->type) {
             case ConsoleCommand::LIST_PLANES: {
-                pthread_mutex_lock(&data_mutex_);
-                PlaneListMsg response;
-                response.numPlanes = aircraftStates_.size();
-
-                for(size_t i = 0; i < response.numPlanes && i < 50; i++) {
-                    response.planes[i] = aircraftStates_[i];
-                }
-                pthread_mutex_unlock(&data_mutex_);
-
-                MsgReply(rcvid, EOK, &response, sizeof(PlaneListMsg));
+                // Replies with the requested chunk straight out of the current snapshot
+                AircraftSnapshots::Reader snapshot(snapshots_);
+                replyAircraftList(rcvid, msg->list, snapshot->frame, snapshot->states);
                 break;
             }
 
             case ConsoleCommand::UPDATE_PLANE_VELOCITY: {
-                pthread_mutex_lock(&data_mutex_);
-                for(auto& plane : aircraftStates_) {
-                    if(strcmp(plane.id, msg->planeId) == 0) {
-                        sendCourseCorrection(plane.id, msg->velocity, plane.coid_comp);
-                        LOG_INFO("ComputerSystem", std::string("Updated velocity for plane ") + msg->planeId);
-                        break;
-                    }
+                msg->planeId[sizeof(msg->planeId) - 1] = '\0';
+                uint32_t handle = AircraftIdTable::getInstance().find(msg->planeId);
+                AircraftSnapshots::Reader snapshot(snapshots_);
+                uint32_t index = snapshot->indexOf(handle);
+                if (index != HandleIndex::NONE) {
+                    const PlaneState& plane = snapshot->states[index];
+                    // Sent with the checker's batch for the next frame
+                    queueCourseCorrection(plane, msg->velocity);
+                    LOG_INFO("ComputerSystem", std::string("Queued velocity update for plane ") + msg->planeId);
                 }
-                pthread_mutex_unlock(&data_mutex_);
                 MsgReply(rcvid, EOK, nullptr, 0);
                 break;
             }
 
+            case ConsoleCommand::FIND_WITHIN_RADIUS:
+            case ConsoleCommand::FIND_IN_BOX:
+            case ConsoleCommand::FIND_NEAREST:
+                replySpatialQuery(rcvid, *msg);
+                break;
+
             case ConsoleCommand::UPDATE_PLANE_POSITION:
             case ConsoleCommand::DISPLAY_PLANE_DATA:
             	sendPlaneDataToConsole(msg->planeId);
@@ -229,53 +373,176 @@ void ComputerSystem::operatorLoop() {
     }
 }
 
-void ComputerSystem::checkForViolations() {
+void ComputerSystem::replySpatialQuery(int rcvid, const OperatorCommandMsg& msg) {
+    // Every chunk of the reply re-runs the query; the console restarts if
+    // the snapshot changes in between, like any aircraft list
+    AircraftSnapshots::Reader snapshot(snapshots_);
+    const KdTree& spatialIndex = snapshot->spatialIndex;
+    const SpatialQuery& query = msg.query;
+    if (msg.type == ConsoleCommand::FIND_WITHIN_RADIUS) {
+        spatialIndex.withinRadius(query.point, query.radius, queryHits_);
+    } else if (msg.type == ConsoleCommand::FIND_IN_BOX) {
+        spatialIndex.withinBox(query.point, query.high, queryHits_);
+    } else {
+        spatialIndex.nearest(query.point, query.count, queryHits_, queryHeap_);
+    }
+
+    queryResults_.clear();
+    for (uint32_t index : queryHits_) {
+        queryResults_.push_back(snapshot->states[index]);
+    }
+    replyAircraftList(rcvid, msg.list, snapshot->frame, queryResults_);
+}
+
+void ComputerSystem::setBroadPhase(BroadPhase broadPhase) {
     pthread_mutex_lock(&data_mutex_);
-    // Copy the aircraft states to a local variable to minimize lock time
-    std::vector<PlaneState> aircraftStatesCopy = aircraftStates_;
-    int lookaheadTime = lookaheadTime_;
+    broadPhase_ = broadPhase;
     pthread_mutex_unlock(&data_mutex_);
+}
 
-    // Predict positions at current_time + n seconds and check for violations
-    for (size_t i = 0; i < aircraftStatesCopy.size(); ++i) {
-        for (size_t j = i + 1; j < aircraftStatesCopy.size(); ++j) {
-            // Predict positions
-            Vector pos1 = aircraftStatesCopy[i].position;
-            Vector speed1 = aircraftStatesCopy[i].velocity;
-            Vector futurePos1 = {
-                pos1.x + speed1.x * lookaheadTime,
-                pos1.y + speed1.y * lookaheadTime,
-                pos1.z + speed1.z * lookaheadTime
-            };
-
-            Vector pos2 = aircraftStatesCopy[j].position;
-            Vector speed2 = aircraftStatesCopy[j].velocity;
-            Vector futurePos2 = {
-                pos2.x + speed2.x * lookaheadTime,
-                pos2.y + speed2.y * lookaheadTime,
-                pos2.z + speed2.z * lookaheadTime
-            };
-
-            // Check separation
-            double horizontalDist = sqrt(pow(futurePos1.x - futurePos2.x, 2) +
-                                         pow(futurePos1.y - futurePos2.y, 2));
-            double verticalDist = fabs(futurePos1.z - futurePos2.z);
-
-            if (horizontalDist < 3.0 && verticalDist < 1.0) {
-                // Violation detected
-                std::string message = "Potential violation between ";
-                message += aircraftStatesCopy[i].id;
-                message += " and ";
-                message += aircraftStatesCopy[j].id;
-                LOG_WARNING("ComputerSystem", message);
-                Vector velocity = aircraftStatesCopy[i].velocity;
-                velocity.z += 1000;
-                std::lock_guard<std::mutex> lock(mtx);
-                sendCourseCorrection(aircraftStatesCopy[i].id, velocity,aircraftStatesCopy[i].coid_comp);
-            }
+void ComputerSystem::setBroadPhaseCrossCheck(bool enabled) {
+    pthread_mutex_lock(&data_mutex_);
+    broadPhaseCrossCheck_ = enabled;
+    pthread_mutex_unlock(&data_mutex_);
+}
+
+void ComputerSystem::setIncrementalDetection(bool enabled) {
+    pthread_mutex_lock(&data_mutex_);
+    incrementalDetection_ = enabled;
+    pthread_mutex_unlock(&data_mutex_);
+}
+
+void ComputerSystem::setIncrementalValidation(bool enabled) {
+    pthread_mutex_lock(&data_mutex_);
+    incrementalValidation_ = enabled;
+    pthread_mutex_unlock(&data_mutex_);
+}
 
+void ComputerSystem::setMaxAcceleration(double acceleration) {
+    pthread_mutex_lock(&data_mutex_);
+    maxAcceleration_ = acceleration;
+    pthread_mutex_unlock(&data_mutex_);
+}
+
+void ComputerSystem::setAlertTracking(bool enabled) {
+    pthread_mutex_lock(&data_mutex_);
+    alertTracking_ = enabled;
+    pthread_mutex_unlock(&data_mutex_);
+}
+
+void ComputerSystem::setLookaheadTiers(const std::vector<LookaheadTier>& tiers) {
+    std::vector<LookaheadTier> config = LookaheadTiers::normalize(tiers);
+    pthread_mutex_lock(&data_mutex_);
+    tierConfig_ = config;
+    tiersChanged_ = true;
+    pthread_mutex_unlock(&data_mutex_);
+
+    pthread_mutex_lock(&frame_mutex_);
+    alertTier_ = LookaheadTiers::emptyStats(config.front());
+    pthread_mutex_unlock(&frame_mutex_);
+}
+
+void ComputerSystem::setWorkerCount(size_t workers) {
+    pthread_mutex_lock(&data_mutex_);
+    workerCount_ = std::max<size_t>(workers, 1);
+    pthread_mutex_unlock(&data_mutex_);
+}
+
+DetectionLatencyStats ComputerSystem::getDetectionLatency() const {
+    pthread_mutex_lock(&frame_mutex_);
+    DetectionLatencyStats stats = latency_;
+    pthread_mutex_unlock(&frame_mutex_);
+    return stats;
+}
+
+AlertStats ComputerSystem::getAlertStats() const {
+    pthread_mutex_lock(&frame_mutex_);
+    AlertStats stats = alertStats_;
+    pthread_mutex_unlock(&frame_mutex_);
+    return stats;
+}
+
+std::vector<TierStats> ComputerSystem::getTierStats() const {
+    pthread_mutex_lock(&frame_mutex_);
+    std::vector<TierStats> stats = tierStats_;
+    if (stats.empty()) {
+        stats.push_back(alertTier_);
+    } else {
+        stats.front() = alertTier_;
+    }
+    pthread_mutex_unlock(&frame_mutex_);
+    return stats;
+}
+
+CourseCorrectionStats ComputerSystem::getCourseCorrectionStats() {
+    return corrections_.getStats();
+}
+
+size_t ComputerSystem::checkForViolations() {
+    // Held for the whole check, conflict indices refer to this snapshot
+    AircraftSnapshots::Reader snapshot(snapshots_);
+    const std::vector<PlaneState>& states = snapshot->states;
+
+    pthread_mutex_lock(&data_mutex_);
+    double lookaheadTime = tierConfig_.front().horizon;
+    detector_.setBroadPhase(broadPhase_);
+    detector_.setCrossCheck(broadPhaseCrossCheck_);
+    size_t workerCount = workerCount_;
+    bool incremental = incrementalDetection_;
+    bool validate = incrementalValidation_;
+    double maxAcceleration = maxAcceleration_;
+    bool alertTracking = alertTracking_;
+    pthread_mutex_unlock(&data_mutex_);
+
+    // Resize the pool from this thread, it is the only user
+    detector_.setWorkerCount(workerCount);
+
+    // Find every pair losing separation within the next n seconds
+    if (incremental) {
+        conflictTable_.setMaxAcceleration(maxAcceleration);
+        conflictTable_.update(*snapshot, lookaheadTime, conflicts_);
+        if (validate) {
+            detector_.detect(states, lookaheadTime, referenceConflicts_);
+            if (!ConflictDetector::samePairs(referenceConflicts_, conflicts_)) {
+                LOG_ERROR("ComputerSystem", "Incremental conflict table mismatch: " +
+                          std::to_string(conflicts_.size()) + " pairs, full detection found " +
+                          std::to_string(referenceConflicts_.size()));
+            }
         }
+    } else {
+        // The table missed these frames, rebuild it when re-enabled
+        conflictTable_.clear();
+        detector_.detect(states, lookaheadTime, conflicts_);
+    }
+
+    // Handle the most imminent conflicts first
+    std::stable_sort(conflicts_.begin(), conflicts_.end(), [](const Conflict& a, const Conflict& b) {
+        return a.approach.timeToConflict < b.approach.timeToConflict;
+    });
+
+    // Alert and correct new conflicts once, known ones only on retry
+    alerts_.setEnabled(alertTracking);
+    alerts_.update(*snapshot, conflicts_, actionable_);
+
+    // Solve each cluster of conflicting aircraft jointly, at most one correction
+    // per aircraft, clear of every other aircraft nearby
+    resolver_.resolve(states, actionable_, lookaheadTime, resolutions_, &snapshot->spatialIndex);
+    for (const auto& resolution : resolutions_) {
+        queueCourseCorrection(states[resolution.index], resolution.velocity);
+    }
+    const ResolverStats& resolved = resolver_.getStats();
+    if (resolved.components > 0) {
+        LOG_EVENT(DEBUG, RESOLVER_CORRECTIONS, resolved.corrections, resolved.components,
+                  resolved.largestComponent);
     }
+    if (resolved.unresolved > 0) {
+        LOG_EVENT(WARNING, RESOLVER_UNRESOLVED, resolved.unresolved);
+    }
+
+    // All of this cycle's corrections, and any operator updates queued since
+    // the last frame, in one send per channel
+    corrections_.flush();
+    return conflicts_.size();
 }
 
 void ComputerSystem::dataDisplayLoop() {
@@ -297,26 +564,8 @@ void ComputerSystem::dataDisplayLoop() {
             }
         } else if (rcvid > 0) {
             // Process data display request
-            pthread_mutex_lock(&data_mutex_);
-            std::vector<PlaneState> aircraftStatesCopy = aircraftStates_;
-            pthread_mutex_unlock(&data_mutex_);
-
-            // Define maximum number of aircraft to send
-            const size_t MAX_AIRCRAFT = 50;
-            if (aircraftStatesCopy.size() > MAX_AIRCRAFT) {
-                aircraftStatesCopy.resize(MAX_AIRCRAFT);
-            }
-
-            // Prepare the reply message
-            ComputerToDataDisplayMsg replyMsg;
-            replyMsg.numAircraft = aircraftStatesCopy.size();
-            for (int i = 0; i < replyMsg.numAircraft; ++i) {
-                replyMsg.aircraftData[i] = aircraftStatesCopy[i];
-            }
-
-            // Send the data to DataDisplay
-            size_t replySize = sizeof(int) + replyMsg.numAircraft * sizeof(PlaneState);
-            int status = MsgReply(rcvid, EOK, &replyMsg, replySize);
+            AircraftSnapshots::Reader snapshot(snapshots_);
+            int status = replyAircraftList(rcvid, requestMsg.list, snapshot->frame, snapshot->states);
             if (status == -1) {
                 LOG_ERROR("ComputerSystem", "Failed to send data to DataDisplay");
             }
@@ -337,56 +586,47 @@ int ComputerSystem::getOperatorChannelId() const {
     return operator_chid_;
 }
 
-void ComputerSystem::sendCourseCorrection(const std::string& planeId, const Vector& velocity, int coid){
-	courseCorrectionMsg msg;
-	msg.id = planeId;
-	msg.newVelocity = velocity;
-
-	int con = ConnectAttach(ND_LOCAL_NODE, 0, coid, _NTO_SIDE_CHANNEL, 0);
-    int status = MsgSend(con, &msg, sizeof(msg), nullptr, 0);
-    ConnectDetach(con);
-
-    if (status == -1){
-        LOG_ERROR("ComputerSystem", "Failed to send Course Correction to Radar");
-    } else {
-        LOG_WARNING("ComputerSystem", "Sent Course Correction to plane " + planeId);
+void ComputerSystem::queueCourseCorrection(const PlaneState& plane, const Vector& velocity) {
+    uint32_t handle = AircraftIdTable::getInstance().find(plane.id);
+    if (handle == AircraftIdTable::INVALID_HANDLE) {
+        LOG_ERROR("ComputerSystem", std::string("No course correction for unknown plane ") + plane.id);
+        return;
     }
+    corrections_.queue(handle, velocity, plane.coid_comp);
 }
 
 
 
 void ComputerSystem::sendPlaneDataToConsole(char planeId[16]){
-	pthread_mutex_lock(&data_mutex_);
-
-	for(size_t i = 0; i < aircraftStates_.size(); ++i){
-		//if the two IDs are equal, print the data in a LOG_WARNING
-		if (std::strcmp(aircraftStates_[i].id, planeId) == 0){
-			PlaneState state = aircraftStates_[i];
-			std::stringstream ss;
-			ss << state.id << " | ("
-			           << state.position.x << ","
-			           << state.position.y << ","
-			           << state.position.z << ") | ("
-			           << state.velocity.x << ","
-			           << state.velocity.y << ","
-			           << state.velocity.z << ")\n";
-			LOG_WARNING("Computer System ", ss.str());
-		}
+	planeId[15] = '\0';
+	uint32_t handle = AircraftIdTable::getInstance().find(planeId);
+
+	AircraftSnapshots::Reader snapshot(snapshots_);
+	uint32_t index = snapshot->indexOf(handle);
+	if (index != HandleIndex::NONE){
+		const PlaneState& state = snapshot->states[index];
+		std::stringstream ss;
+		ss << state.id << " | ("
+		           << state.position.x << ","
+		           << state.position.y << ","
+		           << state.position.z << ") | ("
+		           << state.velocity.x << ","
+		           << state.velocity.y << ","
+		           << state.velocity.z << ")\n";
+		LOG_WARNING("Computer System ", ss.str());
 	}
-
-	pthread_mutex_unlock(&data_mutex_);
 }
 
 
 void ComputerSystem::logAirspaceState() {
-    pthread_mutex_lock(&data_mutex_);
+    AircraftSnapshots::Reader snapshot(snapshots_);
     std::stringstream ss;
 
     ss << "\n=== Airspace State ===";
     ss << "\nTimestamp: " << Logger::getInstance().getTimestamp();
-    ss << "\nAircraft Count: " << aircraftStates_.size();
+    ss << "\nAircraft Count: " << snapshot->states.size();
 
-    for (const auto& aircraft : aircraftStates_) {
+    for (const auto& aircraft : snapshot->states) {
         ss << "\n\nAircraft ID: " << aircraft.id;
         ss << "\nPosition: (" << std::fixed << std::setprecision(2)
            << aircraft.position.x << ", "
@@ -397,8 +637,24 @@ void ComputerSystem::logAirspaceState() {
            << aircraft.velocity.y << ", "
            << aircraft.velocity.z << ")";
     }
+    DetectionLatencyStats latency = getDetectionLatency();
+    ss << "\n\nDetection latency over " << latency.frames << " frames: last "
+       << latency.lastMs << " ms, mean " << latency.meanMs << " ms, max " << latency.maxMs << " ms";
+    AlertStats alerts = getAlertStats();
+    CourseCorrectionStats sent = getCourseCorrectionStats();
+    ss << "\nConflict reports: " << alerts.reports << ", alerts logged " << alerts.raised
+       << ", retries " << alerts.retries << ", suppressed " << alerts.suppressed
+       << ", cleared " << alerts.cleared << ", active " << alerts.active << " (" << alerts.resolving << " resolving)";
+    ss << "\nCourse corrections: " << sent.corrections << " in " << sent.messages << " messages";
+    for (const auto& tier : getTierStats()) {
+        ss << "\nLookahead " << tier.name << " (" << tier.horizon << "s, every " << tier.cadence
+           << " frames): " << tier.checks << " checks, " << tier.conflicts << " conflicts, last "
+           << tier.lastMs << " ms, mean " << tier.meanMs << " ms, " << tier.perFrameMs << " ms per frame";
+    }
+    LogFileStats logFile = Logger::getInstance().getLogFileStats();
+    ss << "\nLog file: " << logFile.bytes / 1e6 << " MB in " << logFile.flushes << " writes, "
+       << logFile.rotations << " rotations, " << logFile.mbPerSecond() << " MB/s while writing";
     ss << "\n===================\n";
 
-    pthread_mutex_unlock(&data_mutex_);
     LOG_TO_FILE("LOG", ss.str());
 }
@@ -0,0 +1,102 @@
+// ConflictAlerts.cpp
+#include "ConflictAlerts.h"
+#include "AircraftIdTable.h"
+#include "Logger.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+// Simulated seconds a reported conflict waits before its correction is re-sent
+const double RETRY_TIMEOUT = 5.0;
+// Simulated seconds a pair must go unreported before it is cleared
+const double CLEAR_HOLD = 3.0;
+}
+
+ConflictAlerts::ConflictAlerts() : enabled_(true) {}
+
+void ConflictAlerts::setEnabled(bool enabled) {
+    if (!enabled) {
+        alerts_.clear();
+        stats_.active = 0;
+        stats_.resolving = 0;
+    }
+    enabled_ = enabled;
+}
+
+uint64_t ConflictAlerts::pairKey(uint32_t a, uint32_t b) {
+    return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+const char* ConflictAlerts::stateName(AlertState state) {
+    switch (state) {
+        case AlertState::NEW:          return "new";
+        case AlertState::ACKNOWLEDGED: return "acknowledged";
+        case AlertState::RESOLVING:    return "resolving";
+        case AlertState::CLEARED:      return "cleared";
+    }
+    return "unknown";
+}
+
+void ConflictAlerts::update(const AircraftSnapshot& snapshot, const std::vector<Conflict>& conflicts,
+                            std::vector<Conflict>& actionable) {
+    actionable.clear();
+    double now = snapshot.time;
+
+    for (const auto& conflict : conflicts) {
+        const PlaneState& first = snapshot.states[conflict.first];
+        const PlaneState& second = snapshot.states[conflict.second];
+        ++stats_.reports;
+
+        uint64_t key = pairKey(snapshot.handles[conflict.first], snapshot.handles[conflict.second]);
+        auto it = enabled_ ? alerts_.find(key) : alerts_.end();
+        if (it == alerts_.end()) {
+            if (enabled_) {
+                alerts_[key] = { AlertState::NEW, now, now };
+            }
+            ++stats_.raised;
+            actionable.push_back(conflict);
+            LOG_EVENT(WARNING, CONFLICT_ALERT, first.id, second.id, conflict.approach.timeToConflict);
+            continue;
+        }
+
+        // Reported again, or back while resolving: no fresh alert, only a
+        // retry once the last correction had time to take effect
+        Alert& alert = it->second;
+        alert.state = AlertState::ACKNOWLEDGED;
+        alert.lastSeen = now;
+        if (now - alert.lastCorrection >= RETRY_TIMEOUT) {
+            alert.lastCorrection = now;
+            ++stats_.retries;
+            actionable.push_back(conflict);
+            LOG_EVENT(WARNING, CONFLICT_RETRY, first.id, second.id);
+        } else {
+            ++stats_.suppressed;
+        }
+    }
+
+    // Pairs not reported this frame start resolving, and clear after the hold
+    stats_.resolving = 0;
+    for (auto it = alerts_.begin(); it != alerts_.end();) {
+        Alert& alert = it->second;
+        bool reported = alert.lastSeen == now;
+        if (!reported && (alert.state == AlertState::NEW || alert.state == AlertState::ACKNOWLEDGED)) {
+            alert.state = AlertState::RESOLVING;
+        }
+        if (alert.state == AlertState::RESOLVING && now - alert.lastSeen >= CLEAR_HOLD) {
+            alert.state = AlertState::CLEARED;
+        }
+        if (alert.state == AlertState::CLEARED) {
+            ++stats_.cleared;
+            LOG_INFO("ComputerSystem", "Conflict between " + AircraftIdTable::getInstance().name(uint32_t(it->first >> 32))
+                     + " and " + AircraftIdTable::getInstance().name(uint32_t(it->first)) + " "
+                     + stateName(alert.state));
+            it = alerts_.erase(it);
+            continue;
+        }
+        if (alert.state == AlertState::RESOLVING) {
+            ++stats_.resolving;
+        }
+        ++it;
+    }
+    stats_.active = alerts_.size();
+}
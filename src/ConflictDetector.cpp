@@ -0,0 +1,241 @@
+// ConflictDetector.cpp
+#include "ConflictDetector.h"
+#include "Config.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// TIME_SLICED slice length, in horizontal minima covered by the fastest
+// aircraft. Shorter slices shrink the cells but cost a grid build each; about
+// three balances the two in the benchmark traffic.
+const double SLICE_MINIMA = 3.0;
+// Upper bound on TIME_SLICED slices, for very fast aircraft
+const size_t MAX_SLICES = 1024;
+// A slice visits a pair at about this many times the cost of the vectorised
+// all-pairs test
+const double SLICE_PAIR_COST = 2.0;
+}
+
+ConflictDetector::ConflictDetector()
+    : broadPhase_(BroadPhase::SPATIAL_GRID), isa_(detectKernelIsa()), crossCheck_(false), buffers_(1) {}
+
+void ConflictDetector::setWorkerCount(size_t workers) {
+    workers = std::max<size_t>(workers, 1);
+    if (workers == getWorkerCount()) {
+        return;
+    }
+    pool_.reset(workers > 1 ? new WorkerPool(workers) : nullptr);
+    buffers_.resize(workers);
+}
+
+void ConflictDetector::detect(const std::vector<PlaneState>& states, double lookahead,
+                              std::vector<Conflict>& conflicts) {
+    detectWith(broadPhase_, states, lookahead, conflicts);
+
+    if (crossCheck_ && broadPhase_ != BroadPhase::BRUTE_FORCE) {
+        detectWith(BroadPhase::BRUTE_FORCE, states, lookahead, reference_);
+        if (!samePairs(reference_, conflicts)) {
+            LOG_ERROR("ConflictDetector", "Broad phase mismatch: " + std::to_string(conflicts.size())
+                      + " conflicts found, brute force found " + std::to_string(reference_.size()));
+        }
+    }
+}
+
+void ConflictDetector::detectWith(BroadPhase broadPhase, const std::vector<PlaneState>& states,
+                                  double lookahead, std::vector<Conflict>& conflicts) {
+    conflicts.clear();
+    spans_.clear();
+
+    bool sliced = false;
+    switch (broadPhase) {
+        case BroadPhase::SPATIAL_GRID: {
+            grid_.build(states, lookahead);
+            grid_.candidateSpans(spans_);
+            soa_.assign(states, grid_.order());
+            break;
+        }
+
+        case BroadPhase::SWEEP_AND_PRUNE: {
+            sweep_.build(states, lookahead);
+            sweep_.candidateSpans(spans_);
+            soa_.assign(states, sweep_.order());
+            break;
+        }
+
+        case BroadPhase::TIME_SLICED:
+            sliced = detectTimeSliced(states, lookahead, conflicts);
+            if (sliced) {
+                break;
+            }
+            // Too dense to slice, where the vectorised all-pairs test is cheaper
+            // fall through
+
+        case BroadPhase::BRUTE_FORCE:
+        default: {
+            soa_.assign(states);
+            uint32_t count = static_cast<uint32_t>(states.size());
+            for (uint32_t i = 0; i + 1 < count; ++i) {
+                spans_.push_back({ i, i + 1, count });
+            }
+            break;
+        }
+    }
+
+    if (!sliced) {
+        narrowPhase(states, lookahead, conflicts);
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), [](const Conflict& a, const Conflict& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    });
+}
+
+void ConflictDetector::narrowPhase(const std::vector<PlaneState>& states, double lookahead,
+                                   std::vector<Conflict>& conflicts) {
+    // Spans per task; small enough to balance, large enough to amortise stealing
+    const size_t GRAIN = 64;
+
+    auto task = [&](size_t begin, size_t end, size_t worker) {
+        WorkerBuffers& buffers = buffers_[worker];
+        buffers.hits.resize(soa_.size());
+        for (size_t s = begin; s < end; ++s) {
+            const CandidateSpan& span = spans_[s];
+            size_t count = separationKernel(isa_, soa_, span.a, span.begin, span.end, lookahead, buffers.hits.data());
+            for (size_t k = 0; k < count; ++k) {
+                uint32_t i = soa_.index(span.a);
+                uint32_t j = soa_.index(buffers.hits[k]);
+                uint32_t first = std::min(i, j);
+                uint32_t second = std::max(i, j);
+                buffers.conflicts.push_back({ first, second, computeClosestApproach(states[first], states[second], lookahead) });
+            }
+        }
+    };
+
+    for (auto& buffers : buffers_) {
+        buffers.conflicts.clear();
+    }
+    if (pool_) {
+        pool_->parallelFor(spans_.size(), GRAIN, task);
+    } else {
+        task(0, spans_.size(), 0);
+    }
+
+    // Merge; detectWith sorts, so the result is independent of which worker found what
+    for (const auto& buffers : buffers_) {
+        conflicts.insert(conflicts.end(), buffers.conflicts.begin(), buffers.conflicts.end());
+    }
+}
+
+// Grid cells for the whole window must cover the distance two aircraft can
+// close over it, so past a minute or so every pair lands in neighbouring
+// cells and the grid degenerates into brute force. Instead the window is cut
+// into slices in which the fastest aircraft covers a few horizontal minima.
+// Each slice places every aircraft at the slice's middle in a dense
+// grid whose cells are the minima plus the largest closing distance over half
+// a slice; a pair can only lose separation inside the slice if it shares or
+// neighbours a cell and is within the minima plus its own closing distance.
+// Survivors get the exact test over the whole window, and a conflict is kept
+// only by the slice in which separation is first lost, so each is reported
+// once without merging. When one grid in the middle of the window suggests
+// the slices would visit more than the all-pairs test costs, as in dense
+// converging traffic, returns false without detecting anything.
+bool ConflictDetector::detectTimeSliced(const std::vector<PlaneState>& states, double lookahead,
+                                        std::vector<Conflict>& conflicts) {
+    double maxSpeedXY = 0.0;
+    double maxSpeedZ = 0.0;
+    for (const auto& s : states) {
+        maxSpeedXY = std::max(maxSpeedXY, std::sqrt(s.velocity.x * s.velocity.x + s.velocity.y * s.velocity.y));
+        maxSpeedZ = std::max(maxSpeedZ, std::fabs(s.velocity.z));
+    }
+    size_t sliceCount = 1;
+    if (maxSpeedXY > 0.0) {
+        double slices = std::ceil(lookahead * maxSpeedXY / (SLICE_MINIMA * Separation::HORIZONTAL));
+        sliceCount = static_cast<size_t>(std::min(std::max(slices, 1.0), double(MAX_SLICES)));
+    }
+    double sliceLength = lookahead / sliceCount;
+    double half = 0.5 * sliceLength;
+    // Absorbs rounding in the slice bound, extra candidates are harmless
+    const double SLACK = 1.0;
+    double cellXY = Separation::HORIZONTAL + 2.0 * maxSpeedXY * half + SLACK;
+    double cellZ = Separation::VERTICAL + 2.0 * maxSpeedZ * half + SLACK;
+
+    SliceGrid& probe = buffers_[0].sliceGrid;
+    probe.build(states, 0.5 * lookahead, cellXY, cellZ);
+    double allPairs = 0.5 * double(states.size()) * double(states.size());
+    if (double(probe.countPairs()) * sliceCount * SLICE_PAIR_COST > allPairs) {
+        return false;
+    }
+
+    auto task = [&](size_t begin, size_t end, size_t worker) {
+        WorkerBuffers& buffers = buffers_[worker];
+        SliceGrid& grid = buffers.sliceGrid;
+        for (size_t slice = begin; slice < end; ++slice) {
+            grid.build(states, (slice + 0.5) * sliceLength, cellXY, cellZ);
+            grid.forEachSpan([&](uint32_t a, uint32_t runBegin, uint32_t runEnd) {
+                for (uint32_t b = runBegin; b < runEnd; ++b) {
+                    // |dv| <= |dvx| + |dvy| keeps the bound loose without a square root
+                    double dx = grid.x(b) - grid.x(a);
+                    double dy = grid.y(b) - grid.y(a);
+                    double dz = grid.z(b) - grid.z(a);
+                    double dvx = grid.vx(b) - grid.vx(a);
+                    double dvy = grid.vy(b) - grid.vy(a);
+                    double dvz = grid.vz(b) - grid.vz(a);
+                    double reachXY = Separation::HORIZONTAL + (std::fabs(dvx) + std::fabs(dvy)) * half + SLACK;
+                    double reachZ = Separation::VERTICAL + std::fabs(dvz) * half + SLACK;
+                    if (dx * dx + dy * dy > reachXY * reachXY || std::fabs(dz) > reachZ) {
+                        continue;
+                    }
+                    // Clearly inside both minima at the start of the slice: an
+                    // earlier slice saw separation lost and reports the pair
+                    if (slice > 0) {
+                        double sx = dx - dvx * half;
+                        double sy = dy - dvy * half;
+                        double sz = dz - dvz * half;
+                        double insideXY = Separation::HORIZONTAL - SLACK;
+                        if (sx * sx + sy * sy < insideXY * insideXY && std::fabs(sz) < Separation::VERTICAL - SLACK) {
+                            continue;
+                        }
+                    }
+
+                    uint32_t first = std::min(grid.index(a), grid.index(b));
+                    uint32_t second = std::max(grid.index(a), grid.index(b));
+                    ClosestApproach approach = computeClosestApproach(states[first], states[second], lookahead);
+                    if (!approach.conflict) {
+                        continue;
+                    }
+                    size_t entered = std::min(static_cast<size_t>(approach.timeToConflict / sliceLength),
+                                              sliceCount - 1);
+                    if (entered == slice) {
+                        buffers.conflicts.push_back({ first, second, approach });
+                    }
+                }
+            });
+        }
+    };
+
+    for (auto& buffers : buffers_) {
+        buffers.conflicts.clear();
+    }
+    if (pool_) {
+        pool_->parallelFor(sliceCount, 1, task);
+    } else {
+        task(0, sliceCount, 0);
+    }
+    for (const auto& buffers : buffers_) {
+        conflicts.insert(conflicts.end(), buffers.conflicts.begin(), buffers.conflicts.end());
+    }
+    return true;
+}
+
+bool ConflictDetector::samePairs(const std::vector<Conflict>& a, const std::vector<Conflict>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t k = 0; k < a.size(); ++k) {
+        if (a[k].first != b[k].first || a[k].second != b[k].second) {
+            return false;
+        }
+    }
+    return true;
+}
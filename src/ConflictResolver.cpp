@@ -0,0 +1,277 @@
+// ConflictResolver.cpp
+#include "ConflictResolver.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Vertical rate changes tried for each aircraft, cheapest first
+const double MANOEUVRES[] = { 0.0, 500.0, -500.0, 1000.0, -1000.0 };
+const size_t MANOEUVRE_COUNT = sizeof(MANOEUVRES) / sizeof(MANOEUVRES[0]);
+const double LARGEST_MANOEUVRE = 1000.0;
+// Components up to this many aircraft are searched exhaustively, 5^4 assignments
+const size_t EXHAUSTIVE_LIMIT = 4;
+const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+PlaneState manoeuvred(const PlaneState& state, uint8_t choice) {
+    PlaneState result = state;
+    result.velocity.z += MANOEUVRES[choice];
+    return result;
+}
+
+bool inConflict(const PlaneState& first, const PlaneState& second, double lookahead) {
+    double enter, exit;
+    if (!conflictWindow(second.position.x - first.position.x, second.position.y - first.position.y,
+                        second.position.z - first.position.z, second.velocity.x - first.velocity.x,
+                        second.velocity.y - first.velocity.y, second.velocity.z - first.velocity.z,
+                        lookahead, enter, exit)) {
+        return false;
+    }
+    // A pair already inside the minima cannot be cleared at once; it counts
+    // as cleared when separation is restored within the lookahead
+    return enter > 0.0 || exit >= lookahead;
+}
+}
+
+uint32_t ConflictResolver::find(uint32_t id) {
+    while (parent_[id] != id) {
+        parent_[id] = parent_[parent_[id]];
+        id = parent_[id];
+    }
+    return id;
+}
+
+uint32_t ConflictResolver::idOf(uint32_t index) const {
+    return static_cast<uint32_t>(std::lower_bound(aircraft_.begin(), aircraft_.end(), index) - aircraft_.begin());
+}
+
+bool ConflictResolver::conflictsWith(const std::vector<PlaneState>& states, uint32_t a, uint32_t b,
+                                     double lookahead) const {
+    return inConflict(manoeuvred(states[aircraft_[a]], choice_[a]), manoeuvred(states[aircraft_[b]], choice_[b]),
+                      lookahead);
+}
+
+void ConflictResolver::collectObstacles(const std::vector<PlaneState>& states, const Component& component,
+                                        const KdTree& spatialIndex, double lookahead) {
+    // Anything that can come within the minima of a member during the
+    // lookahead, whatever manoeuvre the member takes
+    double minima = std::sqrt(Separation::HORIZONTAL * Separation::HORIZONTAL
+                              + Separation::VERTICAL * Separation::VERTICAL);
+    for (uint32_t id : component.members) {
+        const PlaneState& state = states[aircraft_[id]];
+        const Vector& v = state.velocity;
+        double speed = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z) + LARGEST_MANOEUVRE;
+        spatialIndex.withinRadius(state.position, minima + (speed + spatialIndex.getMaxSpeed()) * lookahead, nearby_);
+
+        obstacles_[id].clear();
+        for (uint32_t index : nearby_) {
+            uint32_t other = idOf(index);
+            if (other == aircraft_.size() || aircraft_[other] != index) {
+                other = NONE;
+            } else if (inComponent_[other]) {
+                continue;
+            }
+            obstacles_[id].push_back({ index, other });
+        }
+        stats_.neighbours += obstacles_[id].size();
+    }
+}
+
+size_t ConflictResolver::obstacleConflicts(const std::vector<PlaneState>& states, uint32_t id, double lookahead) const {
+    // Aircraft of components solved earlier fly their chosen manoeuvre
+    PlaneState state = manoeuvred(states[aircraft_[id]], choice_[id]);
+    size_t count = 0;
+    for (const Obstacle& obstacle : obstacles_[id]) {
+        const PlaneState& other = states[obstacle.index];
+        count += obstacle.id == NONE ? inConflict(state, other, lookahead)
+                                     : inConflict(state, manoeuvred(other, choice_[obstacle.id]), lookahead);
+    }
+    return count;
+}
+
+size_t ConflictResolver::conflictsAt(const std::vector<PlaneState>& states, uint32_t id, double lookahead) const {
+    size_t count = 0;
+    for (uint32_t other : adjacent_[id]) {
+        count += conflictsWith(states, id, other, lookahead);
+    }
+    return count + obstacleConflicts(states, id, lookahead);
+}
+
+void ConflictResolver::resolve(const std::vector<PlaneState>& states, const std::vector<Conflict>& conflicts,
+                               double lookahead, std::vector<Resolution>& resolutions,
+                               const KdTree* spatialIndex) {
+    resolutions.clear();
+    stats_ = ResolverStats();
+
+    aircraft_.clear();
+    for (const auto& conflict : conflicts) {
+        aircraft_.push_back(conflict.first);
+        aircraft_.push_back(conflict.second);
+    }
+    std::sort(aircraft_.begin(), aircraft_.end());
+    aircraft_.erase(std::unique(aircraft_.begin(), aircraft_.end()), aircraft_.end());
+
+    size_t count = aircraft_.size();
+    parent_.resize(count);
+    adjacent_.resize(count);
+    for (uint32_t id = 0; id < count; ++id) {
+        parent_[id] = id;
+        adjacent_[id].clear();
+    }
+    choice_.assign(count, 0);
+    inComponent_.assign(count, 0);
+    obstacles_.resize(count);
+    blocked_.assign(count * MANOEUVRE_COUNT, 0);
+
+    // Conflict graph and its connected components
+    for (const auto& conflict : conflicts) {
+        uint32_t a = idOf(conflict.first);
+        uint32_t b = idOf(conflict.second);
+        adjacent_[a].push_back(b);
+        adjacent_[b].push_back(a);
+        parent_[find(a)] = find(b);
+    }
+    components_.clear();
+    std::vector<uint32_t> componentOf(count, NONE);
+    for (uint32_t id = 0; id < count; ++id) {
+        uint32_t root = find(id);
+        if (componentOf[root] == NONE) {
+            componentOf[root] = static_cast<uint32_t>(components_.size());
+            components_.push_back({ {}, std::numeric_limits<double>::infinity() });
+        }
+        components_[componentOf[root]].members.push_back(id);
+    }
+    for (const auto& conflict : conflicts) {
+        Component& component = components_[componentOf[find(idOf(conflict.first))]];
+        component.urgency = std::min(component.urgency, conflict.approach.timeToConflict);
+    }
+    std::stable_sort(components_.begin(), components_.end(), [](const Component& a, const Component& b) {
+        return a.urgency < b.urgency;
+    });
+
+    for (const Component& component : components_) {
+        for (uint32_t id : component.members) {
+            inComponent_[id] = 1;
+            obstacles_[id].clear();
+        }
+        if (spatialIndex != nullptr) {
+            collectObstacles(states, component, *spatialIndex, lookahead);
+        }
+
+        if (component.members.size() <= EXHAUSTIVE_LIMIT) {
+            solveExhaustive(states, component, lookahead);
+        } else {
+            solveGreedy(states, component, lookahead);
+        }
+
+        for (uint32_t id : component.members) {
+            for (uint32_t other : adjacent_[id]) {
+                if (id < other && conflictsWith(states, id, other, lookahead)) {
+                    ++stats_.unresolved;
+                }
+            }
+            if (choice_[id] != 0) {
+                Vector velocity = states[aircraft_[id]].velocity;
+                velocity.z += MANOEUVRES[choice_[id]];
+                resolutions.push_back({ aircraft_[id], velocity });
+            }
+        }
+        for (uint32_t id : component.members) {
+            inComponent_[id] = 0;
+        }
+        stats_.largestComponent = std::max(stats_.largestComponent, component.members.size());
+    }
+    stats_.components = components_.size();
+    stats_.corrections = resolutions.size();
+}
+
+void ConflictResolver::solveExhaustive(const std::vector<PlaneState>& states, const Component& component,
+                                       double lookahead) {
+    // Fewest changed aircraft first, then the smallest total change; every
+    // pair in the component must stay clear, not just the conflicting ones
+    const std::vector<uint32_t>& members = component.members;
+    // Obstacles do not move with the component, so each member's manoeuvres
+    // are checked against them once rather than per assignment
+    for (uint32_t id : members) {
+        for (uint8_t option = 0; option < MANOEUVRE_COUNT; ++option) {
+            choice_[id] = option;
+            blocked_[id * MANOEUVRE_COUNT + option] = obstacleConflicts(states, id, lookahead) > 0;
+        }
+    }
+
+    size_t assignments = 1;
+    for (size_t m = 0; m < members.size(); ++m) {
+        assignments *= MANOEUVRE_COUNT;
+    }
+
+    bool found = false;
+    size_t best = 0;
+    size_t bestChanges = 0;
+    double bestCost = 0.0;
+    for (size_t code = 0; code < assignments; ++code) {
+        size_t digits = code;
+        size_t changes = 0;
+        double cost = 0.0;
+        bool blocked = false;
+        for (uint32_t id : members) {
+            choice_[id] = static_cast<uint8_t>(digits % MANOEUVRE_COUNT);
+            digits /= MANOEUVRE_COUNT;
+            changes += choice_[id] != 0;
+            cost += std::fabs(MANOEUVRES[choice_[id]]);
+            blocked = blocked || blocked_[id * MANOEUVRE_COUNT + choice_[id]];
+        }
+        if (blocked || (found && (changes > bestChanges || (changes == bestChanges && cost >= bestCost)))) {
+            continue;
+        }
+
+        bool clear = true;
+        for (size_t i = 0; i < members.size() && clear; ++i) {
+            for (size_t j = i + 1; j < members.size() && clear; ++j) {
+                clear = !conflictsWith(states, members[i], members[j], lookahead);
+            }
+        }
+        if (clear) {
+            found = true;
+            best = code;
+            bestChanges = changes;
+            bestCost = cost;
+        }
+    }
+
+    if (!found) {
+        for (uint32_t id : members) {
+            choice_[id] = 0;
+        }
+        solveGreedy(states, component, lookahead);
+        return;
+    }
+    for (uint32_t id : members) {
+        choice_[id] = static_cast<uint8_t>(best % MANOEUVRE_COUNT);
+        best /= MANOEUVRE_COUNT;
+    }
+}
+
+void ConflictResolver::solveGreedy(const std::vector<PlaneState>& states, const Component& component,
+                                   double lookahead) {
+    // Most constrained aircraft first; each one still in conflict takes the
+    // cheapest manoeuvre leaving it the fewest conflicts with its neighbours
+    std::vector<uint32_t> order = component.members;
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return adjacent_[a].size() > adjacent_[b].size();
+    });
+
+    for (uint32_t id : order) {
+        size_t fewest = conflictsAt(states, id, lookahead);
+        uint8_t best = choice_[id];
+        for (uint8_t option = 1; option < MANOEUVRE_COUNT && fewest > 0; ++option) {
+            choice_[id] = option;
+            size_t remaining = conflictsAt(states, id, lookahead);
+            if (remaining < fewest) {
+                fewest = remaining;
+                best = option;
+            }
+        }
+        choice_[id] = best;
+    }
+}
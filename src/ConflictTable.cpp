@@ -0,0 +1,552 @@
+// ConflictTable.cpp
+#include "ConflictTable.h"
+#include "Config.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// How far past the lookahead a straight-line certificate is computed, so it
+// can be carried forward; staggered per pair so re-evaluations do not bunch up
+const double CARRY_HORIZON = 30.0;
+// Safety margin on carried guarantees, absorbs rounding between frames
+const double TIME_MARGIN = 1e-3;
+// Largest drift from straight-line motion still treated as unchanged
+const double POSITION_TOLERANCE = 1e-3;
+// Cells are sized for this much more than the fastest aircraft seen, so one
+// faster aircraft does not force a rebuild straight away
+const double SPEED_HEADROOM = 1.25;
+// Pieces a certificate horizon is split into under an acceleration bound;
+// each piece widens the minima by the drift possible at its end
+const int CERTIFICATE_PIECES = 4;
+// Under an acceleration bound a certificate ends once the possible drift
+// reaches this fraction of the pair's separation margin
+const double DRIFT_FRACTION = 0.75;
+// Expiry wheel: bucket width in seconds and bucket count, a power of two.
+// Events further out than the wheel spans wait in a bucket for another turn.
+const double WHEEL_BUCKET = 0.25;
+const size_t WHEEL_SIZE = 512;
+
+const int COORD_BITS = 21;
+const uint64_t COORD_MASK = (uint64_t(1) << COORD_BITS) - 1;
+const int64_t COORD_OFFSET = int64_t(1) << (COORD_BITS - 1);
+
+double horizontalSpeed(const Vector& v) {
+    return std::sqrt(v.x * v.x + v.y * v.y);
+}
+
+double length(double x, double y, double z) {
+    return std::sqrt(x * x + y * y + z * z);
+}
+
+int64_t bucketOf(double time) {
+    return static_cast<int64_t>(std::floor(time / WHEEL_BUCKET));
+}
+}
+
+ConflictTable::ConflictTable()
+    : lookahead_(0.0), maxAcceleration_(0.0), now_(0.0), cellSpeedXY_(0.0), cellSpeedZ_(0.0), cellSizeXY_(1.0), cellSizeZ_(1.0),
+      valid_(false), serial_(0), wheel_(WHEEL_SIZE), wheelCursor_(0), conflicts_(nullptr) {}
+
+void ConflictTable::clear() {
+    valid_ = false;
+    tracks_.clear();
+    cells_.clear();
+    pairs_.clear();
+    freePairs_.clear();
+    for (auto& bucket : wheel_) {
+        bucket.clear();
+    }
+    stats_.trackedPairs = 0;
+}
+
+void ConflictTable::setMaxAcceleration(double acceleration) {
+    acceleration = std::max(acceleration, 0.0);
+    if (acceleration != maxAcceleration_) {
+        // Certificates were issued under the old bound
+        maxAcceleration_ = acceleration;
+        valid_ = false;
+    }
+}
+
+uint64_t ConflictTable::pairKey(uint32_t a, uint32_t b) {
+    return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+// Coordinates wrap instead of clamping; wrapped cells only add candidates
+uint64_t ConflictTable::cellKey(int64_t cx, int64_t cy, int64_t cz) const {
+    return (uint64_t((cx + COORD_OFFSET) & COORD_MASK) << (2 * COORD_BITS)) |
+           (uint64_t((cy + COORD_OFFSET) & COORD_MASK) << COORD_BITS) |
+           uint64_t((cz + COORD_OFFSET) & COORD_MASK);
+}
+
+void ConflictTable::cellOf(const Vector& position, int64_t cell[3]) const {
+    cell[0] = static_cast<int64_t>(std::floor(position.x / cellSizeXY_));
+    cell[1] = static_cast<int64_t>(std::floor(position.y / cellSizeXY_));
+    cell[2] = static_cast<int64_t>(std::floor(position.z / cellSizeZ_));
+}
+
+ConflictTable::Track& ConflictTable::track(uint32_t handle) {
+    if (handle >= tracks_.size()) {
+        tracks_.resize(handle + 1);
+    }
+    return tracks_[handle];
+}
+
+void ConflictTable::update(const AircraftSnapshot& snapshot, double lookahead, std::vector<Conflict>& conflicts) {
+    conflicts.clear();
+    conflicts_ = &conflicts;
+    now_ = snapshot.time;
+    changed_.clear();
+    expired_.clear();
+    stats_.pairsEvaluated = 0;
+    ++stats_.frames;
+
+    // Cells no longer cover the fastest aircraft: start over
+    bool rebuildNeeded = !valid_ || lookahead != lookahead_;
+    for (size_t k = 0; k < snapshot.touched.size() && !rebuildNeeded; ++k) {
+        uint32_t index = snapshot.indexOf(snapshot.touched[k]);
+        if (index == HandleIndex::NONE) {
+            continue;
+        }
+        const Vector& v = snapshot.states[index].velocity;
+        rebuildNeeded = horizontalSpeed(v) > cellSpeedXY_ || std::fabs(v.z) > cellSpeedZ_;
+    }
+    if (rebuildNeeded) {
+        rebuild(snapshot, lookahead);
+    } else {
+        for (uint32_t handle : snapshot.dropped) {
+            if (handle < tracks_.size() && tracks_[handle].present) {
+                detach(handle);
+                tracks_[handle].present = false;
+                tracks_[handle].version = ++serial_;
+            }
+        }
+        for (uint32_t handle : snapshot.touched) {
+            uint32_t index = snapshot.indexOf(handle);
+            if (index == HandleIndex::NONE) {
+                continue;
+            }
+            Track& t = track(handle);
+            Change change = t.present ? classify(t, snapshot.states[index], now_) : Change::DIRTY;
+            if (change != Change::NONE) {
+                mark(handle, change);
+            }
+        }
+
+        // Cell crossings and pair guarantees that ran out by now. Stale events
+        // are dropped here; live ones not due yet go back on the wheel.
+        int64_t last = bucketOf(now_);
+        int64_t stop = std::min(last, wheelCursor_ + int64_t(WHEEL_SIZE) - 1);
+        for (int64_t slot = wheelCursor_; slot <= stop; ++slot) {
+            due_.clear();
+            due_.swap(wheel_[size_t(slot) & (WHEEL_SIZE - 1)]);
+            for (const Event& event : due_) {
+                if (!live(event)) {
+                    continue;
+                }
+                if (event.time > now_) {
+                    schedule(event);
+                } else if (event.pair) {
+                    expired_.push_back(event);
+                } else {
+                    mark(event.key, Change::CROSSED);
+                }
+            }
+        }
+        // The current bucket may still receive events later in this frame
+        wheelCursor_ = last;
+    }
+
+    // Take changed aircraft out, re-place them, then pair them with their
+    // neighbours. Pairing only evaluates pairs that do not exist yet, so an
+    // aircraft that crossed a cell or stayed in its envelope keeps its pairs.
+    size_t dirty = 0;
+    size_t deviated = 0;
+    for (uint32_t handle : changed_) {
+        Track& t = tracks_[handle];
+        if (!t.present) {
+            continue;
+        }
+        if (t.change == Change::DIRTY) {
+            detach(handle);
+            ++dirty;
+        } else {
+            leaveCell(handle);
+            deviated += t.change == Change::DEVIATED;
+        }
+    }
+    for (uint32_t handle : changed_) {
+        uint32_t index = snapshot.indexOf(handle);
+        if (index == HandleIndex::NONE) {
+            tracks_[handle].present = false;
+            continue;
+        }
+        Track& t = tracks_[handle];
+        if (t.change == Change::DEVIATED) {
+            // Kept pairs whose certificate assumed a straight course
+            for (const Partner& partner : t.partners) {
+                const Pair& pair = pairs_[partner.pair];
+                if (pair.straight) {
+                    expired_.push_back({ now_, partner.pair, true, pair.version });
+                }
+            }
+        }
+        if (!place(handle, snapshot.states[index], now_) && t.change != Change::DIRTY) {
+            // Same cell, so it already has a pair with every neighbour
+            t.change = Change::NONE;
+        }
+    }
+    for (uint32_t handle : changed_) {
+        Change change = tracks_[handle].change;
+        if (tracks_[handle].present && (change == Change::CROSSED || change == Change::DEVIATED)) {
+            pruneDistantPartners(handle);
+        }
+    }
+    for (uint32_t handle : changed_) {
+        if (tracks_[handle].present && tracks_[handle].change != Change::NONE) {
+            pairWithNeighbours(handle, snapshot);
+        }
+        tracks_[handle].change = Change::NONE;
+    }
+
+    // Pairs created or re-evaluated above have new versions, so stale and
+    // repeated expiries are skipped here
+    for (const Event& event : expired_) {
+        if (live(event)) {
+            evaluate(event.key, snapshot);
+        }
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), [](const Conflict& a, const Conflict& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    });
+
+    stats_.dirtyAircraft = dirty;
+    stats_.crossedAircraft = changed_.size() - dirty - deviated;
+    stats_.deviatedAircraft = deviated;
+    stats_.trackedPairs = pairs_.size() - freePairs_.size();
+    conflicts_ = nullptr;
+}
+
+void ConflictTable::rebuild(const AircraftSnapshot& snapshot, double lookahead) {
+    clear();
+    valid_ = true;
+    lookahead_ = lookahead;
+    wheelCursor_ = bucketOf(now_);
+    ++stats_.rebuilds;
+
+    // Same sizing rule as SpatialGrid, with headroom on the speed bound
+    double maxSpeedXY = 0.0;
+    double maxSpeedZ = 0.0;
+    for (const auto& s : snapshot.states) {
+        maxSpeedXY = std::max(maxSpeedXY, horizontalSpeed(s.velocity));
+        maxSpeedZ = std::max(maxSpeedZ, std::fabs(s.velocity.z));
+    }
+    cellSpeedXY_ = maxSpeedXY * SPEED_HEADROOM;
+    cellSpeedZ_ = maxSpeedZ * SPEED_HEADROOM;
+    cellSizeXY_ = Separation::HORIZONTAL + 2.0 * cellSpeedXY_ * lookahead;
+    cellSizeZ_ = Separation::VERTICAL + 2.0 * cellSpeedZ_ * lookahead;
+
+    for (uint32_t handle : snapshot.handles) {
+        mark(handle, Change::DIRTY);
+    }
+    LOG_DEBUG("ConflictTable", "Rebuilt for " + std::to_string(snapshot.states.size()) + " aircraft");
+}
+
+void ConflictTable::mark(uint32_t handle, Change change) {
+    Track& t = track(handle);
+    if (t.change == Change::NONE) {
+        changed_.push_back(handle);
+    }
+    if (change > t.change) {
+        t.change = change;
+    }
+}
+
+ConflictTable::Change ConflictTable::classify(const Track& t, const PlaneState& state, double now) const {
+    double elapsed = now - t.time;
+    double drift = length(state.position.x - (t.position.x + t.velocity.x * elapsed),
+                          state.position.y - (t.position.y + t.velocity.y * elapsed),
+                          state.position.z - (t.position.z + t.velocity.z * elapsed));
+    double turn = length(state.velocity.x - t.velocity.x, state.velocity.y - t.velocity.y,
+                         state.velocity.z - t.velocity.z);
+    if (turn == 0.0 && drift <= POSITION_TOLERANCE) {
+        return Change::NONE;
+    }
+
+    // Within drift a*e^2/2 and velocity change a*e of the track, every later
+    // path under the bound stays inside the envelope the certificates assumed
+    double a = maxAcceleration_;
+    if (turn <= a * elapsed && drift <= 0.5 * a * elapsed * elapsed + POSITION_TOLERANCE) {
+        return Change::DEVIATED;
+    }
+    return Change::DIRTY;
+}
+
+void ConflictTable::reanchor(uint32_t handle) {
+    // Same straight line, envelope restarted now; the new envelope lies inside
+    // the old one, so certificates issued earlier stay valid
+    Track& t = tracks_[handle];
+    double elapsed = now_ - t.time;
+    if (elapsed > 0.0) {
+        t.position.x += t.velocity.x * elapsed;
+        t.position.y += t.velocity.y * elapsed;
+        t.position.z += t.velocity.z * elapsed;
+        t.time = now_;
+    }
+}
+
+uint32_t ConflictTable::link(uint32_t a, uint32_t b) {
+    uint32_t slot;
+    if (freePairs_.empty()) {
+        slot = static_cast<uint32_t>(pairs_.size());
+        pairs_.emplace_back();
+    } else {
+        slot = freePairs_.back();
+        freePairs_.pop_back();
+    }
+    Pair& pair = pairs_[slot];
+    pair.handle[0] = a;
+    pair.handle[1] = b;
+    pair.at[0] = static_cast<uint32_t>(tracks_[a].partners.size());
+    pair.at[1] = static_cast<uint32_t>(tracks_[b].partners.size());
+    pair.version = ++serial_;
+    tracks_[a].partners.push_back({ b, slot });
+    tracks_[b].partners.push_back({ a, slot });
+    return slot;
+}
+
+// Removes the pair from one side's partner list, moving that list's last
+// entry into the gap
+void ConflictTable::unlinkFrom(uint32_t slot, int side) {
+    const Pair& pair = pairs_[slot];
+    std::vector<Partner>& partners = tracks_[pair.handle[side]].partners;
+    uint32_t at = pair.at[side];
+    const Partner& moved = partners.back();
+    Pair& movedPair = pairs_[moved.pair];
+    movedPair.at[movedPair.handle[0] == moved.handle ? 1 : 0] = at;
+    partners[at] = moved;
+    partners.pop_back();
+}
+
+void ConflictTable::release(uint32_t slot) {
+    pairs_[slot].version = 0;
+    freePairs_.push_back(slot);
+}
+
+void ConflictTable::detach(uint32_t handle) {
+    Track& t = tracks_[handle];
+    for (const Partner& partner : t.partners) {
+        unlinkFrom(partner.pair, pairs_[partner.pair].handle[0] == handle ? 1 : 0);
+        release(partner.pair);
+    }
+    t.partners.clear();
+    leaveCell(handle);
+}
+
+void ConflictTable::leaveCell(uint32_t handle) {
+    const Track& t = tracks_[handle];
+    auto cell = cells_.find(cellKey(t.cell[0], t.cell[1], t.cell[2]));
+    if (cell != cells_.end()) {
+        std::vector<uint32_t>& members = cell->second;
+        auto it = std::find(members.begin(), members.end(), handle);
+        if (it != members.end()) {
+            *it = members.back();
+            members.pop_back();
+        }
+        if (members.empty()) {
+            cells_.erase(cell);
+        }
+    }
+}
+
+bool ConflictTable::adjacent(const Track& a, const Track& b) const {
+    // Compared as keys so wrapped coordinates agree with the cell lookup
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                if (cellKey(a.cell[0] + dx, a.cell[1] + dy, a.cell[2] + dz) == cellKey(b.cell[0], b.cell[1], b.cell[2])) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ConflictTable::pruneDistantPartners(uint32_t handle) {
+    // Pairs that are no longer candidates; keeping them would be harmless but
+    // would let the table grow without bound
+    std::vector<Partner>& partners = tracks_[handle].partners;
+    size_t kept = 0;
+    for (const Partner& partner : partners) {
+        Pair& pair = pairs_[partner.pair];
+        int side = pair.handle[0] == handle ? 0 : 1;
+        if (adjacent(tracks_[handle], tracks_[partner.handle])) {
+            pair.at[side] = static_cast<uint32_t>(kept);
+            partners[kept++] = partner;
+            continue;
+        }
+        unlinkFrom(partner.pair, 1 - side);
+        release(partner.pair);
+    }
+    partners.resize(kept);
+}
+
+bool ConflictTable::place(uint32_t handle, const PlaneState& state, double now) {
+    Track& t = tracks_[handle];
+    const int64_t previous[3] = { t.cell[0], t.cell[1], t.cell[2] };
+    t.present = true;
+    t.position = state.position;
+    t.velocity = state.velocity;
+    t.time = now;
+    t.version = ++serial_;
+    cellOf(state.position, t.cell);
+    bool changedCell = t.cell[0] != previous[0] || t.cell[1] != previous[1] || t.cell[2] != previous[2];
+    cells_[cellKey(t.cell[0], t.cell[1], t.cell[2])].push_back(handle);
+
+    // Time until the aircraft leaves its cell on any axis
+    const double INF = std::numeric_limits<double>::infinity();
+    const double position[3] = { state.position.x, state.position.y, state.position.z };
+    const double velocity[3] = { state.velocity.x, state.velocity.y, state.velocity.z };
+    const double size[3] = { cellSizeXY_, cellSizeXY_, cellSizeZ_ };
+    double exit = INF;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (velocity[axis] > 0.0) {
+            exit = std::min(exit, ((t.cell[axis] + 1) * size[axis] - position[axis]) / velocity[axis]);
+        } else if (velocity[axis] < 0.0) {
+            exit = std::min(exit, (t.cell[axis] * size[axis] - position[axis]) / velocity[axis]);
+        }
+    }
+    if (exit != INF) {
+        // Never due within the current frame, which is being processed
+        schedule({ std::max(now + exit, std::nextafter(now, INF)), handle, false, t.version });
+    }
+    return changedCell;
+}
+
+void ConflictTable::pairWithNeighbours(uint32_t handle, const AircraftSnapshot& snapshot) {
+    // Existing partners, including pairs created from the other side this
+    // frame, are marked so only new pairs are created
+    uint64_t pass = ++serial_;
+    Track& t = tracks_[handle];
+    t.seen = pass;
+    for (const Partner& partner : t.partners) {
+        tracks_[partner.handle].seen = pass;
+    }
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                auto cell = cells_.find(cellKey(t.cell[0] + dx, t.cell[1] + dy, t.cell[2] + dz));
+                if (cell == cells_.end()) {
+                    continue;
+                }
+                for (uint32_t other : cell->second) {
+                    if (tracks_[other].seen == pass) {
+                        continue;
+                    }
+                    tracks_[other].seen = pass;
+                    evaluate(link(handle, other), snapshot);
+                }
+            }
+        }
+    }
+}
+
+void ConflictTable::evaluate(uint32_t slot, const AircraftSnapshot& snapshot) {
+    ++stats_.pairsEvaluated;
+    Pair& pair = pairs_[slot];
+    uint32_t a = snapshot.indexOf(pair.handle[0]);
+    uint32_t b = snapshot.indexOf(pair.handle[1]);
+    uint32_t first = std::min(a, b);
+    uint32_t second = std::max(a, b);
+    const PlaneState& s1 = snapshot.states[first];
+    const PlaneState& s2 = snapshot.states[second];
+
+    // Any check in the next 'lookahead' seconds stays clear until the certificate runs out
+    double validUntil = now_ + certify(pairKey(pair.handle[0], pair.handle[1]), s1, s2, pair.straight) - lookahead_ - TIME_MARGIN;
+    reanchor(pair.handle[0]);
+    reanchor(pair.handle[1]);
+
+    if (validUntil <= now_) {
+        // Can lose separation inside the lookahead: decide exactly like the full check
+        ClosestApproach approach = computeClosestApproach(s1, s2, lookahead_);
+        if (approach.conflict) {
+            conflicts_->push_back({ first, second, approach });
+        }
+        validUntil = now_; // Looked at again next frame
+    }
+
+    pair.version = ++serial_;
+    schedule({ validUntil, slot, true, pair.version });
+}
+
+double ConflictTable::certify(uint64_t key, const PlaneState& s1, const PlaneState& s2, bool& straight) const {
+    double px = s2.position.x - s1.position.x;
+    double py = s2.position.y - s1.position.y;
+    double pz = s2.position.z - s1.position.z;
+    double vx = s2.velocity.x - s1.velocity.x;
+    double vy = s2.velocity.y - s1.velocity.y;
+    double vz = s2.velocity.z - s1.velocity.z;
+    double enter, exit;
+
+    // Under the bound the relative position drifts at most a*T^2 off the
+    // straight line after T seconds, so widen the minima by that much, up to
+    // the time the drift would eat a fixed share of the current margin
+    double a = maxAcceleration_;
+    double margin = std::max(std::sqrt(px * px + py * py) - Separation::HORIZONTAL,
+                             std::fabs(pz) - Separation::VERTICAL);
+    if (a > 0.0 && margin > 0.0) {
+        double horizon = std::sqrt(DRIFT_FRACTION * margin / a);
+        double certified = horizon;
+        double start = 0.0;
+        for (int k = 1; k <= CERTIFICATE_PIECES && horizon > lookahead_; ++k) {
+            double end = horizon * k / CERTIFICATE_PIECES;
+            double widen = a * end * end;
+            if (conflictWindow(px + vx * start, py + vy * start, pz + vz * start, vx, vy, vz, end - start,
+                               Separation::HORIZONTAL + widen, Separation::VERTICAL + widen, enter, exit)) {
+                certified = start + enter;
+                break;
+            }
+            start = end;
+        }
+        if (certified > lookahead_) {
+            straight = false;
+            return certified;
+        }
+    }
+
+    // Too close or too fast for the bound to help: assume both keep their
+    // course, which any change of velocity breaks
+    straight = true;
+    double horizon = lookahead_ + CARRY_HORIZON * (1.0 + double((key * 0x9E3779B97F4A7C15ULL) >> 56) / 256.0);
+    if (conflictWindow(px, py, pz, vx, vy, vz, horizon, enter, exit)) {
+        return enter;
+    }
+    return horizon;
+}
+
+bool ConflictTable::live(const Event& event) const {
+    if (event.pair) {
+        return pairs_[event.key].version == event.version;
+    }
+    const Track& t = tracks_[event.key];
+    return t.present && t.version == event.version;
+}
+
+int64_t ConflictTable::wheelSlot(double time) const {
+    // Between the cursor, where the next drain starts, and one turn past it;
+    // compared as doubles so far-off cell exits do not overflow
+    int64_t last = wheelCursor_ + int64_t(WHEEL_SIZE) - 1;
+    double bucket = std::floor(time / WHEEL_BUCKET);
+    if (bucket >= double(last)) {
+        return last;
+    }
+    return std::max(static_cast<int64_t>(bucket), wheelCursor_);
+}
+
+void ConflictTable::schedule(const Event& event) {
+    wheel_[size_t(wheelSlot(event.time)) & (WHEEL_SIZE - 1)].push_back(event);
+}
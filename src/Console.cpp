@@ -5,6 +5,7 @@
 #include <sstream>
 #include <cstring>
 #include "Logger.h"
+#include "AircraftTransfer.h"
 #include <unistd.h>
 
 
@@ -77,6 +78,12 @@ Status Console::processUserInput(){
             running_ = false;
         	return Status::OK;
             break;
+        case '5':
+            return findPlanesWithinRadius();
+        case '6':
+            return findPlanesInBox();
+        case '7':
+            return findNearestPlanes();
         default:
             LOG_WARNING("Console", "Invalid command");
             break;
@@ -88,35 +95,99 @@ Status Console::processUserInput(){
 Status Console::listPlanes() {
     OperatorCommandMsg msg;
     msg.type = ConsoleCommand::LIST_PLANES;
+    return requestPlanes(msg, "Current Planes in System");
+}
 
-    // Buffer to receive plane list
-    PlaneListMsg planesList;
-    int status = MsgSend(computerSystemCoid_, &msg, sizeof(msg), &planesList, sizeof(planesList));
-    if (status != EOK) {
+Status Console::requestPlanes(OperatorCommandMsg& msg, const std::string& title) {
+    // Receive the plane list in as many chunks as it takes
+    std::vector<PlaneState> planes;
+    Status status = requestAircraftList(computerSystemCoid_, &msg, sizeof(msg), &msg.list, planes);
+    if (status != Status::OK) {
         LOG_ERROR("Console", "Failed to get plane data");
         return Status::ERROR;
     }
 
     // Create formatted output
     std::stringstream ss;
-    ss << "\nCurrent Planes in System:\n";
+    ss << "\n" << title << ":\n";
     ss << "ID     | Position (x,y,z)        | Velocity (x,y,z)\n";
     ss << "-----------------------------------------------------\n";
 
-    for(int i = 0; i < planesList.numPlanes; i++) {
-        ss << planesList.planes[i].id << " | ("
-           << planesList.planes[i].position.x << ","
-           << planesList.planes[i].position.y << ","
-           << planesList.planes[i].position.z << ") | ("
-           << planesList.planes[i].velocity.x << ","
-           << planesList.planes[i].velocity.y << ","
-           << planesList.planes[i].velocity.z << ")\n";
+    for(const auto& plane : planes) {
+        ss << plane.id << " | ("
+           << plane.position.x << ","
+           << plane.position.y << ","
+           << plane.position.z << ") | ("
+           << plane.velocity.x << ","
+           << plane.velocity.y << ","
+           << plane.velocity.z << ")\n";
     }
 
     LOG_WARNING("Console", ss.str());
     return Status::OK;
 }
 
+Status Console::readVector(const std::string& prompt, Vector& value) {
+    LOG_WARNING("Console", prompt);
+    std::string input;
+    std::getline(std::cin, input);
+
+    std::stringstream ss(input);
+    if (!(ss >> value.x >> value.y >> value.z)) {
+        LOG_ERROR("Console", "Invalid format. Use: x y z");
+        return Status::ERROR;
+    }
+    return Status::OK;
+}
+
+Status Console::findPlanesWithinRadius() {
+    OperatorCommandMsg msg;
+    msg.type = ConsoleCommand::FIND_WITHIN_RADIUS;
+    if (readVector("Enter centre (x y z): ", msg.query.point) != Status::OK) {
+        return Status::ERROR;
+    }
+
+    LOG_WARNING("Console", "Enter radius: ");
+    std::string input;
+    std::getline(std::cin, input);
+    std::stringstream ss(input);
+    if (!(ss >> msg.query.radius) || msg.query.radius < 0.0) {
+        LOG_ERROR("Console", "Invalid radius");
+        return Status::ERROR;
+    }
+    return requestPlanes(msg, "Planes within radius");
+}
+
+Status Console::findPlanesInBox() {
+    OperatorCommandMsg msg;
+    msg.type = ConsoleCommand::FIND_IN_BOX;
+    if (readVector("Enter low corner (x y z): ", msg.query.point) != Status::OK
+        || readVector("Enter high corner (x y z): ", msg.query.high) != Status::OK) {
+        return Status::ERROR;
+    }
+    return requestPlanes(msg, "Planes in box");
+}
+
+Status Console::findNearestPlanes() {
+    OperatorCommandMsg msg;
+    msg.type = ConsoleCommand::FIND_NEAREST;
+    if (readVector("Enter point (x y z): ", msg.query.point) != Status::OK) {
+        return Status::ERROR;
+    }
+
+    LOG_WARNING("Console", "Enter number of planes: ");
+    std::string input;
+    std::getline(std::cin, input);
+    std::stringstream ss(input);
+    int count = 0;
+    if (!(ss >> count) || count <= 0) {
+        LOG_ERROR("Console", "Invalid number of planes");
+        return Status::ERROR;
+    }
+    msg.query.count = static_cast<uint32_t>(count);
+    return requestPlanes(msg, "Nearest planes, closest first");
+}
+
 Status Console::displayPlaneData(){
 	std::string planeId;
 	PlaneState state;
@@ -181,5 +252,8 @@ void Console::displayHelp() {
     helpMenu << "1. Display Plane Data\n";
     helpMenu << "2. Update Plane Velocity\n";
     helpMenu << "3. Exit\n";
+    helpMenu << "5. Find Planes Within Radius\n";
+    helpMenu << "6. Find Planes In Box\n";
+    helpMenu << "7. Find Nearest Planes\n";
     LOG_WARNING("Console", helpMenu.str());
 }
@@ -0,0 +1,138 @@
+// CourseCorrection.cpp
+#include "CourseCorrection.h"
+#include <sys/neutrino.h>
+#include <sys/netmgr.h>
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include "Logger.h"
+
+CourseCorrectionSender::~CourseCorrectionSender() {
+    for (const auto& entry : channels_) {
+        ConnectDetach(entry.second.coid);
+    }
+}
+
+void CourseCorrectionSender::queue(uint32_t handle, const Vector& velocity, int chid) {
+    std::lock_guard<std::mutex> lock(mtx);
+    Pending pending;
+    pending.chid = chid;
+    pending.msg.handle = handle;
+    pending.msg.reserved = 0;
+    pending.msg.newVelocity = velocity;
+    pending_.push_back(pending);
+}
+
+CourseCorrectionStats CourseCorrectionSender::getStats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stats_;
+}
+
+size_t CourseCorrectionSender::flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pending_.empty()) {
+        return 0;
+    }
+
+    // Group by channel, keeping the queue order within each batch
+    std::stable_sort(pending_.begin(), pending_.end(), [](const Pending& a, const Pending& b) {
+        return a.chid < b.chid;
+    });
+
+    size_t delivered = 0;
+    size_t begin = 0;
+    while (begin < pending_.size()) {
+        int chid = pending_[begin].chid;
+        size_t end = begin;
+        batch_.clear();
+        int coid = -1;
+        while (end < pending_.size() && pending_[end].chid == chid) {
+            int connection = connect(pending_[end].msg.handle, chid);
+            if (connection != -1) {
+                coid = connection;
+                batch_.push_back(pending_[end].msg);
+            }
+            ++end;
+        }
+
+        if (coid != -1) {
+            CourseCorrectionHeader header;
+            header.count = static_cast<uint32_t>(batch_.size());
+            header.reserved = 0;
+            iov_t iov[2];
+            SETIOV(&iov[0], &header, sizeof(header));
+            SETIOV(&iov[1], batch_.data(), batch_.size() * sizeof(CourseCorrectionMsg));
+            if (MsgSendvs(coid, iov, 2, nullptr, 0) == -1) {
+                LOG_ERROR("CourseCorrection", "Failed to send " + std::to_string(batch_.size())
+                          + " course corrections: " + strerror(errno));
+                // Most likely the channel is gone, reconnect on the next send
+                disconnect(chid);
+            } else {
+                delivered += batch_.size();
+                ++stats_.messages;
+                stats_.corrections += batch_.size();
+                LOG_DEBUG("CourseCorrection", "Sent " + std::to_string(batch_.size())
+                          + " course corrections");
+            }
+        }
+        begin = end;
+    }
+    pending_.clear();
+    return delivered;
+}
+
+void CourseCorrectionSender::invalidate(uint32_t handle) {
+    std::lock_guard<std::mutex> lock(mtx);
+    release(handle);
+}
+
+int CourseCorrectionSender::connect(uint32_t handle, int chid) {
+    if (handle >= aircraftChannel_.size()) {
+        aircraftChannel_.resize(handle + 1, -1);
+    }
+    if (aircraftChannel_[handle] != chid) {
+        release(handle);
+    }
+
+    auto it = channels_.find(chid);
+    if (it == channels_.end()) {
+        int coid = ConnectAttach(ND_LOCAL_NODE, 0, chid, _NTO_SIDE_CHANNEL, 0);
+        if (coid == -1) {
+            LOG_ERROR("CourseCorrection", "Failed to connect to course correction channel "
+                      + std::to_string(chid));
+            return -1;
+        }
+        it = channels_.emplace(chid, Channel{ coid, 0 }).first;
+    }
+    if (aircraftChannel_[handle] != chid) {
+        aircraftChannel_[handle] = chid;
+        ++it->second.refs;
+    }
+    return it->second.coid;
+}
+
+void CourseCorrectionSender::release(uint32_t handle) {
+    if (handle >= aircraftChannel_.size() || aircraftChannel_[handle] == -1) {
+        return;
+    }
+    auto it = channels_.find(aircraftChannel_[handle]);
+    aircraftChannel_[handle] = -1;
+    if (it != channels_.end() && --it->second.refs == 0) {
+        ConnectDetach(it->second.coid);
+        channels_.erase(it);
+    }
+}
+
+void CourseCorrectionSender::disconnect(int chid) {
+    auto it = channels_.find(chid);
+    if (it == channels_.end()) {
+        return;
+    }
+    ConnectDetach(it->second.coid);
+    channels_.erase(it);
+    for (auto& channel : aircraftChannel_) {
+        if (channel == chid) {
+            channel = -1;
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <algorithm> // For std::find
 #include "Logger.h"
+#include "AircraftTransfer.h"
 #include "radar.h"
 DataDisplay::DataDisplay(int computerSystemCoid)
     : computerSystemCoid_(computerSystemCoid), running_(false) {}
@@ -51,19 +52,16 @@ void DataDisplay::requestDataFromComputerSystem() {
     DataDisplayRequestMsg requestMsg;
     requestMsg.requestAugmentedData = !augmentedAircraftIds_.empty();
 
-    // Prepare to receive the reply
-    ComputerToDataDisplayMsg replyMsg;
     LOG_INFO("DataDisplay", "Requesting data from ComputerSystem");
 
-    int status = MsgSend(computerSystemCoid_, &requestMsg, sizeof(requestMsg), &replyMsg, sizeof(replyMsg));
-    if (status == -1) {
+    std::vector<PlaneState> planes;
+    Status status = requestAircraftList(computerSystemCoid_, &requestMsg, sizeof(requestMsg), &requestMsg.list, planes);
+    if (status == Status::ERROR) {
       LOG_ERROR("DataDisplay", "Failed to request data from ComputerSystem");
     } else {
-        // status will be EOK (0)
-        int numAircraft = replyMsg.numAircraft;
         std::lock_guard<std::mutex> lock(mtx);
-        aircraftStates_.assign(replyMsg.aircraftData, replyMsg.aircraftData + numAircraft);
-        LOG_INFO("DataDisplay", "Received " + std::to_string(numAircraft) + " aircraft from ComputerSystem.");
+        aircraftStates_.swap(planes);
+        LOG_INFO("DataDisplay", "Received " + std::to_string(aircraftStates_.size()) + " aircraft from ComputerSystem.");
     }
 }
 
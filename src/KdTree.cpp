@@ -0,0 +1,207 @@
+// KdTree.cpp
+#include "KdTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Ranges this small are scanned rather than split further
+const size_t LEAF_SIZE = 8;
+}
+
+KdTree::KdTree() : maxSpeed_(0.0) {}
+
+void KdTree::build(const std::vector<PlaneState>& states) {
+    // Positions are copied in so the build and the queries never touch the
+    // much larger PlaneState records
+    size_t n = states.size();
+    entries_.resize(n);
+    axis_.assign(n, 0);
+    maxSpeed_ = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const Vector& p = states[i].position;
+        const Vector& v = states[i].velocity;
+        entries_[i] = { { p.x, p.y, p.z }, static_cast<uint32_t>(i) };
+        maxSpeed_ = std::max(maxSpeed_, std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z));
+    }
+
+    buildRange(0, n);
+}
+
+void KdTree::buildRange(size_t begin, size_t end) {
+    if (end - begin <= LEAF_SIZE) {
+        return;
+    }
+
+    double low[3], high[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        low[axis] = high[axis] = entries_[begin].p[axis];
+    }
+    for (size_t e = begin + 1; e < end; ++e) {
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = std::min(low[axis], entries_[e].p[axis]);
+            high[axis] = std::max(high[axis], entries_[e].p[axis]);
+        }
+    }
+    int axis = 0;
+    for (int a = 1; a < 3; ++a) {
+        if (high[a] - low[a] > high[axis] - low[axis]) {
+            axis = a;
+        }
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(entries_.begin() + begin, entries_.begin() + mid, entries_.begin() + end,
+                     [axis](const Entry& a, const Entry& b) { return a.p[axis] < b.p[axis]; });
+    axis_[mid] = static_cast<uint8_t>(axis);
+
+    buildRange(begin, mid);
+    buildRange(mid + 1, end);
+}
+
+double KdTree::coord(size_t entry, int axis) const {
+    return entries_[entry].p[axis];
+}
+
+double KdTree::distance2(size_t entry, const double point[3]) const {
+    const double* p = entries_[entry].p;
+    double dx = p[0] - point[0];
+    double dy = p[1] - point[1];
+    double dz = p[2] - point[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void KdTree::withinRadius(const Vector& center, double radius, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (radius < 0.0) {
+        return;
+    }
+    double point[3] = { center.x, center.y, center.z };
+    radiusRange(0, entries_.size(), point, radius * radius, out);
+}
+
+void KdTree::radiusRange(size_t begin, size_t end, const double center[3], double radius2,
+                         std::vector<uint32_t>& out) const {
+    if (end - begin <= LEAF_SIZE) {
+        for (size_t e = begin; e < end; ++e) {
+            if (distance2(e, center) <= radius2) {
+                out.push_back(entries_[e].index);
+            }
+        }
+        return;
+    }
+
+    // Left of the median lies at or below its coordinate, right at or above
+    size_t mid = begin + (end - begin) / 2;
+    int axis = axis_[mid];
+    double d = center[axis] - coord(mid, axis);
+    if (distance2(mid, center) <= radius2) {
+        out.push_back(entries_[mid].index);
+    }
+    if (d <= 0.0 || d * d <= radius2) {
+        radiusRange(begin, mid, center, radius2, out);
+    }
+    if (d >= 0.0 || d * d <= radius2) {
+        radiusRange(mid + 1, end, center, radius2, out);
+    }
+}
+
+void KdTree::withinBox(const Vector& low, const Vector& high, std::vector<uint32_t>& out) const {
+    out.clear();
+    double lo[3] = { low.x, low.y, low.z };
+    double hi[3] = { high.x, high.y, high.z };
+    boxRange(0, entries_.size(), lo, hi, out);
+}
+
+void KdTree::boxRange(size_t begin, size_t end, const double low[3], const double high[3],
+                      std::vector<uint32_t>& out) const {
+    auto inside = [&](size_t e) {
+        for (int axis = 0; axis < 3; ++axis) {
+            double c = coord(e, axis);
+            if (c < low[axis] || c > high[axis]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (end - begin <= LEAF_SIZE) {
+        for (size_t e = begin; e < end; ++e) {
+            if (inside(e)) {
+                out.push_back(entries_[e].index);
+            }
+        }
+        return;
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    int axis = axis_[mid];
+    double split = coord(mid, axis);
+    if (inside(mid)) {
+        out.push_back(entries_[mid].index);
+    }
+    if (low[axis] <= split) {
+        boxRange(begin, mid, low, high, out);
+    }
+    if (high[axis] >= split) {
+        boxRange(mid + 1, end, low, high, out);
+    }
+}
+
+void KdTree::nearest(const Vector& point, size_t k, std::vector<uint32_t>& out,
+                     std::vector<Candidate>& heap) const {
+    out.clear();
+    if (k == 0 || entries_.empty()) {
+        return;
+    }
+    double p[3] = { point.x, point.y, point.z };
+    heap.clear();
+    heap.reserve(std::min(k, entries_.size()) + 1);
+    nearestRange(0, entries_.size(), p, k, heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    out.reserve(heap.size());
+    for (const auto& candidate : heap) {
+        out.push_back(entries_[candidate.entry].index);
+    }
+}
+
+void KdTree::offer(size_t entry, const double point[3], size_t k, std::vector<Candidate>& heap) const {
+    // Max-heap on distance holding the k closest so far
+    double d2 = distance2(entry, point);
+    if (heap.size() < k) {
+        heap.push_back({ d2, static_cast<uint32_t>(entry) });
+        std::push_heap(heap.begin(), heap.end());
+    } else if (d2 < heap.front().distance2) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = { d2, static_cast<uint32_t>(entry) };
+        std::push_heap(heap.begin(), heap.end());
+    }
+}
+
+void KdTree::nearestRange(size_t begin, size_t end, const double point[3], size_t k,
+                          std::vector<Candidate>& heap) const {
+    if (end - begin <= LEAF_SIZE) {
+        for (size_t e = begin; e < end; ++e) {
+            offer(e, point, k, heap);
+        }
+        return;
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    int axis = axis_[mid];
+    double d = point[axis] - coord(mid, axis);
+    offer(mid, point, k, heap);
+
+    // Near side first, so the far side is usually pruned
+    if (d <= 0.0) {
+        nearestRange(begin, mid, point, k, heap);
+        if (heap.size() < k || d * d < heap.front().distance2) {
+            nearestRange(mid + 1, end, point, k, heap);
+        }
+    } else {
+        nearestRange(mid + 1, end, point, k, heap);
+        if (heap.size() < k || d * d < heap.front().distance2) {
+            nearestRange(begin, mid, point, k, heap);
+        }
+    }
+}
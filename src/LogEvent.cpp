@@ -0,0 +1,140 @@
+// LogEvent.cpp
+#include "LogEvent.h"
+#include "Timestamp.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+const LogEventFormat FORMATS[] = {
+    { "Plane", "Plane {} updated position to ({}, {}, {})" },
+    { "Radar", "Plane {} out of bounds at ({}, {}, {})" },
+    { "Radar", "Sent frame with {} aircraft to ComputerSystem, {} bytes for {} as full frames ({}x)" },
+    { "ComputerSystem", "Potential violation between {} and {} in {}s" },
+    { "ComputerSystem", "Conflict between {} and {} unresolved, re-sending correction" },
+    { "ComputerSystem", "{} corrections for {} conflict clusters, largest {} aircraft" },
+    { "ComputerSystem", "{} conflicts left unresolved this frame" },
+    { "SimulationEngine", "Advanced {} aircraft" },
+};
+static_assert(sizeof(FORMATS) / sizeof(FORMATS[0]) == static_cast<size_t>(LogEvent::COUNT),
+              "Every LogEvent needs a format");
+
+const uint8_t ERROR_LEVEL = 3; // Logger::Level::ERROR
+
+// Appends the argument at 'in' to 'line'; returns the next one, or nullptr if malformed
+const char* formatArg(const char* in, const char* end, std::string& line) {
+    if (in >= end) {
+        return nullptr;
+    }
+    char text[32];
+    uint8_t type = static_cast<uint8_t>(*in++);
+    if (type == logevent::STRING) {
+        if (in >= end || in + 1 + static_cast<uint8_t>(*in) > end) {
+            return nullptr;
+        }
+        size_t length = static_cast<uint8_t>(*in++);
+        line.append(in, length);
+        return in + length;
+    }
+    if (in + 8 > end) {
+        return nullptr;
+    }
+    if (type == logevent::DOUBLE) {
+        double value;
+        memcpy(&value, in, 8);
+        // Same text as std::to_string
+        snprintf(text, sizeof(text), "%f", value);
+    } else if (type == logevent::INT) {
+        int64_t value;
+        memcpy(&value, in, 8);
+        snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+    } else if (type == logevent::UINT) {
+        uint64_t value;
+        memcpy(&value, in, 8);
+        snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+    } else {
+        return nullptr;
+    }
+    line += text;
+    return in + 8;
+}
+}
+
+const LogEventFormat& logEventFormat(LogEvent event) {
+    return FORMATS[static_cast<size_t>(event)];
+}
+
+bool formatLogEvent(const char* record, size_t size, std::string& line) {
+    LogEventHeader header;
+    if (size < sizeof(header) + 1) {
+        return false;
+    }
+    memcpy(&header, record, sizeof(header));
+    if (header.size != size || header.event >= static_cast<uint16_t>(LogEvent::COUNT)
+        || static_cast<uint8_t>(record[size - 1]) != LOG_EVENT_END) {
+        return false;
+    }
+    const LogEventFormat& format = FORMATS[header.event];
+
+    // Same layout as a text line: HH:MM:SS.mmm, level for errors, tag, message
+    char timestamp[Timestamp::TEXT_LENGTH];
+    size_t start = line.size();
+    line.append(timestamp, Timestamp::format(header.timeNs, timestamp));
+    if (header.level == ERROR_LEVEL) {
+        line += "[ ERROR ]";
+    }
+    line += "[ ";
+    line += format.tag;
+    line += "] ";
+
+    const char* in = record + sizeof(header);
+    const char* end = record + size - 1;
+    uint8_t used = 0;
+    for (const char* f = format.format; *f != '\0'; ++f) {
+        if (f[0] == '{' && f[1] == '}' && used < header.argc) {
+            in = formatArg(in, end, line);
+            if (in == nullptr) {
+                line.resize(start);
+                return false;
+            }
+            ++used;
+            ++f;
+        } else {
+            line += *f;
+        }
+    }
+    line += '\n';
+    return true;
+}
+
+Status decodeLogFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << "\n";
+        return Status::ERROR;
+    }
+
+    std::vector<char> record(LOG_EVENT_MAX_BYTES);
+    std::string line;
+    uint64_t offset = 0;
+    while (file.read(record.data(), sizeof(uint16_t))) {
+        uint16_t size;
+        memcpy(&size, record.data(), sizeof(size));
+        if (size == 0) {
+            // Preallocated space past the last record
+            break;
+        }
+        if (size < sizeof(LogEventHeader) + 1 || size > record.size()
+            || !file.read(record.data() + sizeof(size), size - sizeof(size))
+            || !formatLogEvent(record.data(), size, line)) {
+            std::cerr << "Malformed record at offset " << offset << " of " << path << "\n";
+            return Status::ERROR;
+        }
+        std::cout << line;
+        line.clear();
+        offset += size;
+    }
+    std::cout.flush();
+    return Status::OK;
+}
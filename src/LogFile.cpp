@@ -0,0 +1,188 @@
+// LogFile.cpp
+#include "LogFile.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+const size_t BUFFER_BYTES = 1024 * 1024;
+const uint64_t FLUSH_INTERVAL_NS = 1000ULL * 1000 * 1000;
+// Read back per step when looking for the written end of a reopened file
+const size_t SCAN_BYTES = 64 * 1024;
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// End of the data in a file that may carry zeroed, preallocated space
+off_t writtenEnd(int fd) {
+    off_t end = lseek(fd, 0, SEEK_END);
+    std::vector<char> block(SCAN_BYTES);
+    while (end > 0) {
+        off_t start = end > off_t(SCAN_BYTES) ? end - off_t(SCAN_BYTES) : 0;
+        ssize_t got = pread(fd, block.data(), size_t(end - start), start);
+        if (got <= 0) {
+            break;
+        }
+        for (ssize_t i = got - 1; i >= 0; --i) {
+            if (block[i] != '\0') {
+                return start + i + 1;
+            }
+        }
+        end = start;
+    }
+    return end;
+}
+}
+
+LogFile::LogFile()
+    : maxBytes_(DEFAULT_MAX_BYTES), keep_(DEFAULT_KEEP), fd_(-1), nextFd_(-1), written_(0),
+      buffered_(0), bufferedSince_(0) {}
+
+LogFile::~LogFile() {
+    close();
+}
+
+Status LogFile::open(const std::string& path, size_t maxBytes, unsigned keep) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ == -1) {
+        return Status::ERROR;
+    }
+    path_ = path;
+    maxBytes_ = std::max<size_t>(maxBytes, BUFFER_BYTES);
+    keep_ = keep;
+    buffer_.resize(BUFFER_BYTES);
+    buffered_ = 0;
+
+    written_ = uint64_t(writtenEnd(fd_));
+    lseek(fd_, off_t(written_), SEEK_SET);
+    if (written_ < maxBytes_) {
+        posix_fallocate(fd_, off_t(written_), off_t(maxBytes_ - written_));
+    }
+    prepareNext();
+    return Status::OK;
+}
+
+void LogFile::close() {
+    if (fd_ == -1) {
+        return;
+    }
+    flush();
+    // Give back the preallocated space nothing was written to
+    ftruncate(fd_, off_t(written_));
+    ::close(fd_);
+    fd_ = -1;
+    if (nextFd_ != -1) {
+        ::close(nextFd_);
+        nextFd_ = -1;
+        unlink((path_ + ".next").c_str());
+    }
+}
+
+void LogFile::append(const char* data, size_t size) {
+    if (fd_ == -1) {
+        return;
+    }
+    if (written_ + buffered_ > 0 && written_ + buffered_ + size > maxBytes_) {
+        flush();
+        rotate();
+        if (fd_ == -1) {
+            return;
+        }
+    }
+    if (buffered_ + size > buffer_.size()) {
+        flush();
+    }
+    if (size > buffer_.size()) {
+        // Larger than the whole buffer, straight to the file
+        uint64_t start = Timestamp::monotonicNanos();
+        if (writeAll(fd_, data, size)) {
+            written_ += size;
+            stats_.bytes += size;
+        }
+        ++stats_.flushes;
+        stats_.writeSeconds += (Timestamp::monotonicNanos() - start) * 1e-9;
+        return;
+    }
+
+    if (buffered_ == 0) {
+        bufferedSince_ = Timestamp::monotonicNanos();
+    }
+    memcpy(buffer_.data() + buffered_, data, size);
+    buffered_ += size;
+}
+
+void LogFile::flush() {
+    if (fd_ == -1 || buffered_ == 0) {
+        return;
+    }
+    uint64_t start = Timestamp::monotonicNanos();
+    if (writeAll(fd_, buffer_.data(), buffered_)) {
+        written_ += buffered_;
+        stats_.bytes += buffered_;
+    }
+    ++stats_.flushes;
+    stats_.writeSeconds += (Timestamp::monotonicNanos() - start) * 1e-9;
+    buffered_ = 0;
+}
+
+void LogFile::flushIfDue() {
+    if (buffered_ > 0 && Timestamp::monotonicNanos() - bufferedSince_ >= FLUSH_INTERVAL_NS) {
+        flush();
+    }
+}
+
+std::string LogFile::rotatedPath(unsigned generation) const {
+    return path_ + "." + std::to_string(generation);
+}
+
+void LogFile::rotate() {
+    ftruncate(fd_, off_t(written_));
+    ::close(fd_);
+
+    // path.(keep - 1) -> path.keep, ..., path -> path.1
+    if (keep_ == 0) {
+        unlink(path_.c_str());
+    } else {
+        for (unsigned generation = keep_ - 1; generation >= 1; --generation) {
+            rename(rotatedPath(generation).c_str(), rotatedPath(generation + 1).c_str());
+        }
+        rename(path_.c_str(), rotatedPath(1).c_str());
+    }
+
+    if (nextFd_ != -1 && rename((path_ + ".next").c_str(), path_.c_str()) == 0) {
+        fd_ = nextFd_;
+    } else {
+        if (nextFd_ != -1) {
+            ::close(nextFd_);
+        }
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+    nextFd_ = -1;
+    written_ = 0;
+    ++stats_.rotations;
+    prepareNext();
+}
+
+void LogFile::prepareNext() {
+    nextFd_ = ::open((path_ + ".next").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (nextFd_ != -1) {
+        posix_fallocate(nextFd_, 0, off_t(maxBytes_));
+    }
+}
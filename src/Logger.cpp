@@ -0,0 +1,506 @@
+// Logger.cpp
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+// How long the writer sleeps between passes when nobody asks for a flush
+const long WRITER_INTERVAL_NS = 5 * 1000 * 1000;
+// Batches are written out once they grow past this
+const size_t BATCH_BYTES = 256 * 1024;
+const char* const DEFAULT_LOG_FILE = "log.txt";
+
+// Ring record header; the record takes align8(sizeof(Frame) + bytes)
+struct Frame {
+    uint32_t bytes; // Payload that follows
+    uint32_t kind;
+};
+const uint32_t FRAME_PADDING = 0; // Fills the end of the ring, the next record is at its start
+const uint32_t FRAME_TEXT = 1;
+const uint32_t FRAME_EVENT = 2;
+
+const uint32_t TAG_EMPTY = 0;
+const uint32_t TAG_CLAIMED = 1; // Name being written
+const uint32_t TAG_READY = 2;
+
+// FNV-1a over the part of the tag a filter keeps
+uint32_t tagHash(const char* tag, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(tag[i])) * 16777619u;
+    }
+    return hash;
+}
+
+size_t frameSize(size_t bytes) {
+    return (sizeof(Frame) + bytes + 7) & ~size_t(7);
+}
+
+void writeAll(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+}
+
+Logger::Logger()
+    : binaryEnabled_(false), overflowPolicy_(OverflowPolicy::BLOCK), writerRunning_(false), flushRequests_(0), flushesDone_(0),
+      stopping_(false), writes_(0), bytes_(0), sharedRecords_(0) {
+    // By default, enable all except DEBUG
+    enableAll();
+    disable(Level::DEBUG);
+
+    for (auto& slot : rings_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    batch_.reserve(BATCH_BYTES + Ring::BYTES);
+    binaryBatch_.reserve(BATCH_BYTES + Ring::BYTES);
+    pthread_mutex_init(&mutex_, nullptr);
+    pthread_cond_init(&wake_, nullptr);
+    pthread_cond_init(&flushed_, nullptr);
+
+    // Without the writer every line is written synchronously
+    if (pthread_create(&writer_, nullptr, Logger::writerThreadFunc, this) == 0) {
+        writerRunning_.store(true, std::memory_order_release);
+    }
+}
+
+Logger::~Logger() {
+    // Rings are left to the process exit: a thread still running at static
+    // destruction may yet log into its own
+    shutdown();
+    pthread_cond_destroy(&flushed_);
+    pthread_cond_destroy(&wake_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+Logger::RingHandle::~RingHandle() {
+    if (ring != nullptr) {
+        ring->owned.store(false, std::memory_order_release);
+    }
+}
+
+Logger::Ring* Logger::threadRing() {
+    static thread_local RingHandle handle;
+    if (handle.ring != nullptr) {
+        return handle.ring;
+    }
+
+    // Reuse a ring released by an exited thread, or allocate one in an empty slot
+    for (auto& slot : rings_) {
+        Ring* ring = slot.load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            Ring* created = new Ring();
+            if (slot.compare_exchange_strong(ring, created, std::memory_order_acq_rel)) {
+                handle.ring = created;
+                return created;
+            }
+            delete created;
+        }
+        bool released = false;
+        if (ring->owned.compare_exchange_strong(released, true, std::memory_order_acq_rel)) {
+            handle.ring = ring;
+            return ring;
+        }
+    }
+    // More live threads than slots: this one logs synchronously
+    return nullptr;
+}
+
+Logger::TagFilter& Logger::tagFilter(const char* tag) {
+    size_t length = strnlen(tag, TagFilter::NAME_BYTES - 1);
+    uint32_t hash = tagHash(tag, length);
+    for (size_t probe = 0; probe < TAG_SLOTS; ++probe) {
+        TagFilter& filter = tags_[(hash + probe) % TAG_SLOTS];
+        uint32_t state = filter.state.load(std::memory_order_acquire);
+        if (state == TAG_EMPTY) {
+            if (filter.state.compare_exchange_strong(state, TAG_CLAIMED, std::memory_order_acquire)) {
+                memcpy(filter.name, tag, length);
+                filter.name[length] = '\0';
+                filter.state.store(TAG_READY, std::memory_order_release);
+                return filter;
+            }
+        }
+        // Another thread is adding a tag here, its name is a few stores away
+        while (state == TAG_CLAIMED) {
+            sched_yield();
+            state = filter.state.load(std::memory_order_acquire);
+        }
+        if (strncmp(filter.name, tag, length) == 0 && filter.name[length] == '\0') {
+            return filter;
+        }
+    }
+    return untracked_;
+}
+
+Status Logger::setTagLevel(const std::string& tag, Level minimum) {
+    TagFilter& filter = tagFilter(tag);
+    if (&filter == &untracked_) {
+        return Status::ERROR;
+    }
+    uint32_t all = (1u << static_cast<uint32_t>(Level::COUNT)) - 1;
+    filter.levels.store(all & ~((1u << static_cast<uint32_t>(minimum)) - 1), std::memory_order_relaxed);
+    return Status::OK;
+}
+
+void Logger::clearTagLevel(const std::string& tag) {
+    TagFilter& filter = tagFilter(tag);
+    if (&filter != &untracked_) {
+        filter.levels.store(TagFilter::INHERIT, std::memory_order_relaxed);
+    }
+}
+
+void Logger::log(Level level, const std::string tag, const std::string& message) {
+    char timestamp[Timestamp::TEXT_LENGTH];
+    size_t timestampLength = Timestamp::now(timestamp);
+    bool error = level == Logger::Level::ERROR;
+    Piece pieces[] = {
+        { timestamp, timestampLength },
+        { "[ ERROR ]", error ? sizeof("[ ERROR ]") - 1 : 0 },
+        { "[ ", 2 },
+        { tag.data(), tag.size() },
+        { "] ", 2 },
+        { message.data(), message.size() },
+        { "\n", 1 },
+    };
+    const size_t count = sizeof(pieces) / sizeof(pieces[0]);
+    size_t total = 0;
+    for (const auto& piece : pieces) {
+        total += piece.size;
+    }
+
+    // Records up to half the ring always fit once it drains, larger ones go out directly
+    Ring* ring = writerRunning_.load(std::memory_order_acquire) ? threadRing() : nullptr;
+    if (ring == nullptr || total > Ring::BYTES / 2) {
+        // Keep this thread's earlier lines ahead of this one
+        flush();
+        writeDirect(pieces, count);
+        return;
+    }
+
+    uint64_t end;
+    char* out = reserve(*ring, FRAME_TEXT, total, end);
+    if (out == nullptr) {
+        if (!writerRunning_.load(std::memory_order_acquire)) {
+            writeDirect(pieces, count);
+        }
+        return;
+    }
+    for (const auto& piece : pieces) {
+        memcpy(out, piece.data, piece.size);
+        out += piece.size;
+    }
+    commit(*ring, end);
+    if (error) {
+        flush();
+    }
+}
+
+void Logger::writeEvent(Level level, const char* record, size_t size) {
+    Ring* ring = writerRunning_.load(std::memory_order_acquire) ? threadRing() : nullptr;
+    char* out = nullptr;
+    uint64_t end = 0;
+    if (ring != nullptr) {
+        out = reserve(*ring, FRAME_EVENT, size, end);
+    }
+    if (out == nullptr) {
+        if (ring == nullptr || !writerRunning_.load(std::memory_order_acquire)) {
+            // No writer to defer to, format it here
+            std::string line;
+            formatLogEvent(record, size, line);
+            Piece piece = { line.data(), line.size() };
+            flush();
+            writeDirect(&piece, 1);
+        }
+        return;
+    }
+    memcpy(out, record, size);
+    commit(*ring, end);
+    if (level == Level::ERROR) {
+        flush();
+    }
+}
+
+char* Logger::reserve(Ring& ring, uint32_t kind, size_t bytes, uint64_t& end) {
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    size_t size = frameSize(bytes);
+    size_t offset = head & (Ring::BYTES - 1);
+    // Records never wrap: skip the rest of the ring if this one does not fit
+    size_t padding = offset + size > Ring::BYTES ? Ring::BYTES - offset : 0;
+
+    bool waited = false;
+    while (Ring::BYTES - (head - ring.tail.load(std::memory_order_acquire)) < padding + size) {
+        OverflowPolicy policy = getOverflowPolicy();
+        if (policy != OverflowPolicy::BLOCK) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            if (policy == OverflowPolicy::COUNT) {
+                ring.lost.fetch_add(1, std::memory_order_relaxed);
+            }
+            return nullptr;
+        }
+        if (!writerRunning_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        if (!waited) {
+            ring.blocked.fetch_add(1, std::memory_order_relaxed);
+            waited = true;
+        }
+        wakeWriter();
+        sched_yield();
+    }
+
+    if (padding > 0) {
+        Frame frame = { static_cast<uint32_t>(padding - sizeof(Frame)), FRAME_PADDING };
+        memcpy(ring.data + offset, &frame, sizeof(frame));
+        head += padding;
+        offset = 0;
+    }
+    Frame frame = { static_cast<uint32_t>(bytes), kind };
+    memcpy(ring.data + offset, &frame, sizeof(frame));
+    end = head + size;
+    return ring.data + offset + sizeof(Frame);
+}
+
+void Logger::commit(Ring& ring, uint64_t end) {
+    ring.head.store(end, std::memory_order_release);
+    ring.records.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::writeDirect(const Piece* pieces, size_t count) {
+    std::string line;
+    for (size_t p = 0; p < count; ++p) {
+        line.append(pieces[p].data, pieces[p].size);
+    }
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    writeAll(line.data(), line.size());
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(line.size(), std::memory_order_relaxed);
+    sharedRecords_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::wakeWriter() {
+    pthread_mutex_lock(&mutex_);
+    pthread_cond_signal(&wake_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+void Logger::flush() {
+    if (!writerRunning_.load(std::memory_order_acquire) || pthread_equal(pthread_self(), writer_)) {
+        return;
+    }
+    pthread_mutex_lock(&mutex_);
+    uint64_t request = ++flushRequests_;
+    pthread_cond_signal(&wake_);
+    while (flushesDone_ < request) {
+        pthread_cond_wait(&flushed_, &mutex_);
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+void Logger::shutdown() {
+    // From here on callers write synchronously, behind the writer's last batch
+    if (!writerRunning_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    pthread_mutex_lock(&mutex_);
+    stopping_ = true;
+    pthread_cond_signal(&wake_);
+    pthread_mutex_unlock(&mutex_);
+    pthread_join(writer_, nullptr);
+
+    // Lines that raced with the writer's last pass
+    drainAll();
+    writeBatch();
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    file_.close();
+    binaryFile_.close();
+}
+
+Status Logger::openBinaryLog(const std::string& path, size_t maxBytes, unsigned keep) {
+    Status status;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        status = binaryFile_.open(path, maxBytes, keep);
+    }
+    binaryEnabled_.store(status == Status::OK, std::memory_order_release);
+    if (status != Status::OK) {
+        LOG_ERROR("Logger", "Failed to open binary log " + path);
+    }
+    return status;
+}
+
+Status Logger::openLogFile(const std::string& path, size_t maxBytes, unsigned keep) {
+    Status status;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        status = file_.open(path, maxBytes, keep);
+    }
+    if (status != Status::OK) {
+        LOG_ERROR("Logger", "Failed to open log file " + path);
+    }
+    return status;
+}
+
+Status Logger::logToFile(const std::string tag, const std::string& message) {
+    // Appended whole, so a rotation never splits it
+    char timestamp[Timestamp::TEXT_LENGTH];
+    std::string line(timestamp, Timestamp::now(timestamp));
+    line.reserve(line.size() + tag.size() + message.size() + 4);
+    line += "[";
+    line += tag;
+    line += "] ";
+    line += message;
+    line += "\n";
+    bool opened;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        opened = file_.isOpen() || file_.open(DEFAULT_LOG_FILE) == Status::OK;
+        if (opened) {
+            file_.append(line.data(), line.size());
+        }
+    }
+    if (!opened) {
+        LOG_ERROR("Logger", "Failed to open log file");
+        return Status::ERROR;
+    }
+    return Status::OK;
+}
+
+LogFileStats Logger::getLogFileStats() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return file_.getStats();
+}
+
+void Logger::flushFile(bool force) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (force) {
+        file_.flush();
+        binaryFile_.flush();
+    } else {
+        file_.flushIfDue();
+        binaryFile_.flushIfDue();
+    }
+}
+
+void* Logger::writerThreadFunc(void* arg) {
+    static_cast<Logger*>(arg)->writerLoop();
+    return nullptr;
+}
+
+void Logger::writerLoop() {
+    while (true) {
+        pthread_mutex_lock(&mutex_);
+        if (!stopping_ && flushRequests_ == flushesDone_) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += WRITER_INTERVAL_NS;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&wake_, &mutex_, &deadline);
+        }
+        // Everything published before these requests is drained below
+        uint64_t requested = flushRequests_;
+        bool stopping = stopping_;
+        pthread_mutex_unlock(&mutex_);
+
+        drainAll();
+        writeBatch();
+        // A flush request covers the file too
+        flushFile(requested != flushesDone_);
+
+        pthread_mutex_lock(&mutex_);
+        // The last pass also releases flushes that came in after it started
+        flushesDone_ = stopping ? UINT64_MAX : requested;
+        pthread_cond_broadcast(&flushed_);
+        pthread_mutex_unlock(&mutex_);
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void Logger::drainAll() {
+    for (auto& slot : rings_) {
+        Ring* ring = slot.load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        bool binary = binaryEnabled_.load(std::memory_order_acquire);
+        while (tail != head) {
+            const char* record = ring->data + (tail & (Ring::BYTES - 1));
+            Frame frame;
+            memcpy(&frame, record, sizeof(frame));
+            const char* payload = record + sizeof(Frame);
+            if (frame.kind == FRAME_TEXT) {
+                batch_.append(payload, frame.bytes);
+            } else if (frame.kind == FRAME_EVENT) {
+                if (binary) {
+                    binaryBatch_.append(payload, frame.bytes);
+                } else {
+                    formatLogEvent(payload, frame.bytes, batch_);
+                }
+            }
+            tail += frameSize(frame.bytes);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        uint64_t lost = ring->lost.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            char timestamp[Timestamp::TEXT_LENGTH];
+            batch_.append(timestamp, Timestamp::now(timestamp));
+            batch_ += "[ Logger] " + std::to_string(lost) + " messages dropped, log buffer full\n";
+        }
+        if (batch_.size() >= BATCH_BYTES || binaryBatch_.size() >= BATCH_BYTES) {
+            writeBatch();
+        }
+    }
+}
+
+void Logger::writeBatch() {
+    if (!binaryBatch_.empty()) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        binaryFile_.append(binaryBatch_.data(), binaryBatch_.size());
+        binaryBatch_.clear();
+    }
+    if (batch_.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    writeAll(batch_.data(), batch_.size());
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batch_.clear();
+}
+
+LoggerStats Logger::getStats() const {
+    LoggerStats stats;
+    for (const auto& slot : rings_) {
+        const Ring* ring = slot.load(std::memory_order_acquire);
+        if (ring != nullptr) {
+            stats.records += ring->records.load(std::memory_order_relaxed);
+            stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+            stats.blocked += ring->blocked.load(std::memory_order_relaxed);
+        }
+    }
+    stats.records += sharedRecords_.load(std::memory_order_relaxed);
+    stats.writes = writes_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
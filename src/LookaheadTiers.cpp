@@ -0,0 +1,83 @@
+// LookaheadTiers.cpp
+#include "LookaheadTiers.h"
+#include "Logger.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <utility>
+#include <cstdio>
+
+LookaheadTiers::LookaheadTiers() {
+    configure(defaults(3.0));
+}
+
+std::vector<LookaheadTier> LookaheadTiers::defaults(double alertHorizon) {
+    return {
+        { "alert", alertHorizon, 1, BroadPhase::SPATIAL_GRID },
+        { "advisory", 60.0, 10, BroadPhase::TIME_SLICED },
+        { "strategic", 600.0, 60, BroadPhase::TIME_SLICED },
+    };
+}
+
+std::vector<LookaheadTier> LookaheadTiers::normalize(std::vector<LookaheadTier> tiers) {
+    if (tiers.empty()) {
+        tiers = defaults(3.0);
+    }
+    std::stable_sort(tiers.begin(), tiers.end(), [](const LookaheadTier& a, const LookaheadTier& b) {
+        return a.horizon < b.horizon;
+    });
+    tiers.front().cadence = 1;
+    for (auto& tier : tiers) {
+        tier.cadence = std::max<uint32_t>(tier.cadence, 1);
+    }
+    return tiers;
+}
+
+TierStats LookaheadTiers::emptyStats(const LookaheadTier& tier) {
+    TierStats stats;
+    stats.name = tier.name;
+    stats.horizon = tier.horizon;
+    stats.cadence = tier.cadence;
+    return stats;
+}
+
+void LookaheadTiers::configure(std::vector<LookaheadTier> tiers) {
+    tiers_ = normalize(std::move(tiers));
+    stats_.clear();
+    for (const auto& tier : tiers_) {
+        stats_.push_back(emptyStats(tier));
+    }
+}
+
+void LookaheadTiers::record(TierStats& stats, size_t conflicts, double ms) {
+    ++stats.checks;
+    stats.conflicts = conflicts;
+    stats.lastMs = ms;
+    stats.meanMs += (ms - stats.meanMs) / stats.checks;
+    stats.perFrameMs = stats.meanMs / stats.cadence;
+}
+
+void LookaheadTiers::checkLongerTiers(uint64_t lastFrame, uint64_t frame, const std::vector<PlaneState>& states) {
+    for (size_t t = 1; t < tiers_.size(); ++t) {
+        const LookaheadTier& tier = tiers_[t];
+        if (frame / tier.cadence == lastFrame / tier.cadence) {
+            continue;
+        }
+
+        uint64_t start = Timestamp::monotonicNanos();
+        detector_.setBroadPhase(tier.broadPhase);
+        detector_.detect(states, tier.horizon, conflicts_);
+        double ms = (Timestamp::monotonicNanos() - start) / 1e6;
+
+        // Conflicts inside the shorter horizon were already reported there
+        double shorter = tiers_[t - 1].horizon;
+        size_t own = std::count_if(conflicts_.begin(), conflicts_.end(), [shorter](const Conflict& c) {
+            return c.approach.timeToConflict >= shorter;
+        });
+        record(stats_[t], own, ms);
+        if (own > 0) {
+            char range[64];
+            snprintf(range, sizeof(range), " conflicts between %gs and %gs ahead", shorter, tier.horizon);
+            LOG_INFO("ComputerSystem", tier.name + ": " + std::to_string(own) + range);
+        }
+    }
+}
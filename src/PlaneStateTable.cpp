@@ -0,0 +1,116 @@
+// PlaneStateTable.cpp
+#include "PlaneStateTable.h"
+#include "Logger.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+PlaneStateTable::PlaneStateTable(size_t capacity)
+    : capacity_(capacity), bytes_(capacity * sizeof(PlaneStateSlot)),
+      name_("/atc_planes_" + std::to_string(getpid())), fd_(-1), slots_(nullptr) {
+    fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd_ == -1) {
+        LOG_ERROR("PlaneStateTable", "shm_open failed: " + std::string(strerror(errno)));
+        return;
+    }
+    if (ftruncate(fd_, bytes_) == -1) {
+        LOG_ERROR("PlaneStateTable", "ftruncate failed: " + std::string(strerror(errno)));
+        return;
+    }
+    void* addr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR("PlaneStateTable", "mmap failed: " + std::string(strerror(errno)));
+        return;
+    }
+
+    // Fresh shared memory is zero-filled: every slot inactive, sequence 0
+    slots_ = static_cast<PlaneStateSlot*>(addr);
+    freeSlots_.reserve(capacity_);
+    for (size_t i = capacity_; i > 0; --i) {
+        freeSlots_.push_back(static_cast<int>(i - 1));
+    }
+}
+
+PlaneStateTable::~PlaneStateTable() {
+    if (slots_ != nullptr) {
+        munmap(slots_, bytes_);
+    }
+    if (fd_ != -1) {
+        close(fd_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+int PlaneStateTable::acquire(const std::string& id) {
+    if (!isValid()) {
+        return -1;
+    }
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (freeSlots_.empty()) {
+            return -1;
+        }
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    PlaneStateSlot& s = slots_[slot];
+    uint32_t seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    strncpy(s.id, id.c_str(), sizeof(s.id));
+    s.id[sizeof(s.id) - 1] = '\0';
+    s.active = 1;
+    s.sequence.store(seq + 2, std::memory_order_release);
+    return slot;
+}
+
+void PlaneStateTable::release(int slot) {
+    if (slot < 0 || !isValid()) {
+        return;
+    }
+    PlaneStateSlot& s = slots_[slot];
+    uint32_t seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.active = 0;
+    s.sequence.store(seq + 2, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    freeSlots_.push_back(slot);
+}
+
+void PlaneStateTable::publish(int slot, const Vector& position, const Vector& velocity) {
+    PlaneStateSlot& s = slots_[slot];
+    uint32_t seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.position[0] = position.x;
+    s.position[1] = position.y;
+    s.position[2] = position.z;
+    s.velocity[0] = velocity.x;
+    s.velocity[1] = velocity.y;
+    s.velocity[2] = velocity.z;
+    s.sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool PlaneStateTable::read(int slot, char id[16], Vector& position, Vector& velocity) const {
+    const PlaneStateSlot& s = slots_[slot];
+    uint32_t before, after;
+    bool active;
+    do {
+        before = s.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue; // Writer in progress
+        }
+        active = s.active != 0;
+        memcpy(id, s.id, sizeof(s.id));
+        position = Vector(s.position[0], s.position[1], s.position[2]);
+        velocity = Vector(s.velocity[0], s.velocity[1], s.velocity[2]);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = s.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return active;
+}
@@ -0,0 +1,187 @@
+// RadarFrame.cpp
+#include "RadarFrame.h"
+#include "AircraftTransfer.h"
+#include "Logger.h"
+#include <sys/neutrino.h>
+#include <cmath>
+#include <algorithm>
+
+RadarFrameEncoder::RadarFrameEncoder(uint32_t keyframeInterval, double positionTolerance)
+    : keyframeInterval_(keyframeInterval > 0 ? keyframeInterval : 1), positionTolerance_(positionTolerance),
+      frame_(0), keyframe_(true), forceKeyframe_(true), dt_(0.0), measured_(0), stats_() {}
+
+void RadarFrameEncoder::begin(double dt) {
+    keyframe_ = forceKeyframe_ || (frame_ % keyframeInterval_) == 0;
+    forceKeyframe_ = false;
+    dt_ = dt;
+    measured_ = 0;
+    added_.clear();
+    changed_.clear();
+    removed_.clear();
+
+    if (keyframe_) {
+        // The receiver drops everything it had, rebuild the mirror from this sweep
+        tracks_.clear();
+        return;
+    }
+    // Advance our copy of the receiver's picture exactly as it will
+    for (auto& entry : tracks_) {
+        Prediction& p = entry.second;
+        p.position.x += p.velocity.x * dt;
+        p.position.y += p.velocity.y * dt;
+        p.position.z += p.velocity.z * dt;
+    }
+}
+
+void RadarFrameEncoder::track(uint32_t track, const PlaneState& state) {
+    ++measured_;
+    auto it = tracks_.find(track);
+    if (it == tracks_.end()) {
+        added_.push_back({ track, state });
+        tracks_[track] = { state.position, state.velocity };
+        return;
+    }
+
+    Prediction& p = it->second;
+    double dx = state.position.x - p.position.x;
+    double dy = state.position.y - p.position.y;
+    double dz = state.position.z - p.position.z;
+    bool velocityChanged = state.velocity.x != p.velocity.x ||
+                           state.velocity.y != p.velocity.y ||
+                           state.velocity.z != p.velocity.z;
+    bool drifted = dx * dx + dy * dy + dz * dz > positionTolerance_ * positionTolerance_;
+    if (velocityChanged || drifted) {
+        changed_.push_back({ track, state.position, state.velocity });
+        p.position = state.position;
+        p.velocity = state.velocity;
+    }
+}
+
+void RadarFrameEncoder::remove(uint32_t track) {
+    if (tracks_.erase(track) > 0 && !keyframe_) {
+        removed_.push_back(track);
+    }
+}
+
+Status RadarFrameEncoder::send(int coid) {
+    RadarFrameHeader header;
+    header.type = keyframe_ ? RadarFrameType::KEYFRAME : RadarFrameType::DELTA;
+    header.frame = frame_++;
+    header.dt = dt_;
+    header.addedCount = static_cast<uint32_t>(added_.size());
+    header.changedCount = static_cast<uint32_t>(changed_.size());
+    header.removedCount = static_cast<uint32_t>(removed_.size());
+    header.reserved = 0;
+
+    iov_t iov[4];
+    SETIOV(&iov[0], &header, sizeof(header));
+    SETIOV(&iov[1], added_.data(), added_.size() * sizeof(TrackAdded));
+    SETIOV(&iov[2], changed_.data(), changed_.size() * sizeof(TrackChanged));
+    SETIOV(&iov[3], removed_.data(), removed_.size() * sizeof(uint32_t));
+
+    size_t bytes = 0;
+    for (const auto& part : iov) {
+        bytes += part.iov_len;
+    }
+    ++stats_.frames;
+    stats_.keyframes += keyframe_ ? 1 : 0;
+    stats_.bytesSent += bytes;
+    stats_.fullFrameBytes += sizeof(AircraftListHeader) + measured_ * sizeof(PlaneState);
+
+    if (MsgSendvs(coid, iov, 4, nullptr, 0) == -1) {
+        // The receiver may be out of step now, resynchronise with a keyframe
+        forceKeyframe_ = true;
+        return Status::ERROR;
+    }
+    return Status::OK;
+}
+
+Status RadarFrameDecoder::apply(int rcvid, const RadarFrameHeader& header, std::vector<PlaneState>& states) {
+    added_.resize(header.addedCount);
+    changed_.resize(header.changedCount);
+    removed_.resize(header.removedCount);
+
+    iov_t iov[3];
+    SETIOV(&iov[0], added_.data(), added_.size() * sizeof(TrackAdded));
+    SETIOV(&iov[1], changed_.data(), changed_.size() * sizeof(TrackChanged));
+    SETIOV(&iov[2], removed_.data(), removed_.size() * sizeof(uint32_t));
+    size_t bytes = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+    if (bytes > 0) {
+        int read = MsgReadv(rcvid, iov, 3, sizeof(header));
+        if (read == -1 || static_cast<size_t>(read) != bytes) {
+            return Status::ERROR;
+        }
+    }
+
+    dropped_.clear();
+    touched_.clear();
+    if (header.type == RadarFrameType::KEYFRAME) {
+        // Everything not in the keyframe is dropped, sorted out after the adds
+        dropped_.swap(tracks_);
+        states.clear();
+        tracks_.clear();
+        index_.clear();
+    } else {
+        // Straight-line motion since the previous frame
+        for (auto& state : states) {
+            state.position.x += state.velocity.x * header.dt;
+            state.position.y += state.velocity.y * header.dt;
+            state.position.z += state.velocity.z * header.dt;
+        }
+    }
+
+    for (const auto& record : removed_) {
+        if (index_.find(record) != HandleIndex::NONE) {
+            removeTrack(record, states);
+            dropped_.push_back(record);
+        }
+    }
+    for (const auto& record : added_) {
+        addTrack(record.track, record.state, states);
+        touched_.push_back(record.track);
+    }
+    if (header.type == RadarFrameType::KEYFRAME) {
+        dropped_.erase(std::remove_if(dropped_.begin(), dropped_.end(), [this](uint32_t track) {
+            return index_.find(track) != HandleIndex::NONE;
+        }), dropped_.end());
+    }
+    for (const auto& record : changed_) {
+        uint32_t slot = index_.find(record.track);
+        if (slot == HandleIndex::NONE) {
+            LOG_WARNING("RadarFrameDecoder", "Update for unknown track " + std::to_string(record.track));
+            continue;
+        }
+        states[slot].position = record.position;
+        states[slot].velocity = record.velocity;
+        touched_.push_back(record.track);
+    }
+    return Status::OK;
+}
+
+void RadarFrameDecoder::addTrack(uint32_t track, const PlaneState& state, std::vector<PlaneState>& states) {
+    uint32_t slot = index_.find(track);
+    if (slot != HandleIndex::NONE) {
+        states[slot] = state;
+        return;
+    }
+    index_.set(track, static_cast<uint32_t>(states.size()));
+    tracks_.push_back(track);
+    states.push_back(state);
+}
+
+void RadarFrameDecoder::removeTrack(uint32_t track, std::vector<PlaneState>& states) {
+    uint32_t slot = index_.find(track);
+    if (slot == HandleIndex::NONE) {
+        return;
+    }
+    // Swap with the last entry to keep the list dense
+    uint32_t last = static_cast<uint32_t>(states.size() - 1);
+    if (slot != last) {
+        states[slot] = states[last];
+        tracks_[slot] = tracks_[last];
+        index_.set(tracks_[slot], slot);
+    }
+    states.pop_back();
+    tracks_.pop_back();
+    index_.erase(track);
+}
@@ -0,0 +1,146 @@
+// SeparationKernel.cpp
+#include "SeparationKernel.h"
+#include "ClosestApproach.h"
+#include "Config.h"
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEPARATION_KERNEL_AVX2 1
+#endif
+
+namespace {
+
+size_t separationKernelScalar(const AircraftSoA& soa, uint32_t a, uint32_t begin, uint32_t end,
+                              double lookahead, uint32_t* hits) {
+    const double* x = soa.x();
+    const double* y = soa.y();
+    const double* z = soa.z();
+    const double* vx = soa.vx();
+    const double* vy = soa.vy();
+    const double* vz = soa.vz();
+
+    size_t count = 0;
+    double enter, exit;
+    for (uint32_t j = begin; j < end; ++j) {
+        if (conflictWindow(x[j] - x[a], y[j] - y[a], z[j] - z[a],
+                           vx[j] - vx[a], vy[j] - vy[a], vz[j] - vz[a],
+                           lookahead, enter, exit)) {
+            hits[count++] = j;
+        }
+    }
+    return count;
+}
+
+#ifdef SEPARATION_KERNEL_AVX2
+// Lane-wise copy of conflictWindow; keep the operation order identical so
+// both kernels agree bit for bit
+__attribute__((target("avx2")))
+size_t separationKernelAvx2(const AircraftSoA& soa, uint32_t a, uint32_t begin, uint32_t end,
+                            double lookahead, uint32_t* hits) {
+    const double INF = std::numeric_limits<double>::infinity();
+    const double H = Separation::HORIZONTAL;
+    const double V = Separation::VERTICAL;
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d inf = _mm256_set1_pd(INF);
+    const __m256d negInf = _mm256_set1_pd(-INF);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d hSquared = _mm256_set1_pd(H * H);
+    const __m256d vSep = _mm256_set1_pd(V);
+    const __m256d negVSep = _mm256_set1_pd(-V);
+    const __m256d window = _mm256_set1_pd(lookahead);
+
+    const double* x = soa.x();
+    const double* y = soa.y();
+    const double* z = soa.z();
+    const double* vx = soa.vx();
+    const double* vy = soa.vy();
+    const double* vz = soa.vz();
+
+    const __m256d ax = _mm256_set1_pd(x[a]);
+    const __m256d ay = _mm256_set1_pd(y[a]);
+    const __m256d az = _mm256_set1_pd(z[a]);
+    const __m256d avx = _mm256_set1_pd(vx[a]);
+    const __m256d avy = _mm256_set1_pd(vy[a]);
+    const __m256d avz = _mm256_set1_pd(vz[a]);
+
+    size_t count = 0;
+    uint32_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m256d px = _mm256_sub_pd(_mm256_loadu_pd(x + j), ax);
+        __m256d py = _mm256_sub_pd(_mm256_loadu_pd(y + j), ay);
+        __m256d pz = _mm256_sub_pd(_mm256_loadu_pd(z + j), az);
+        __m256d rvx = _mm256_sub_pd(_mm256_loadu_pd(vx + j), avx);
+        __m256d rvy = _mm256_sub_pd(_mm256_loadu_pd(vy + j), avy);
+        __m256d rvz = _mm256_sub_pd(_mm256_loadu_pd(vz + j), avz);
+
+        // Horizontal interval
+        __m256d qa = _mm256_add_pd(_mm256_mul_pd(rvx, rvx), _mm256_mul_pd(rvy, rvy));
+        __m256d qb = _mm256_add_pd(_mm256_mul_pd(px, rvx), _mm256_mul_pd(py, rvy));
+        __m256d qc = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(px, px), _mm256_mul_pd(py, py)), hSquared);
+        __m256d disc = _mm256_sub_pd(_mm256_mul_pd(qb, qb), _mm256_mul_pd(qa, qc));
+        __m256d root = _mm256_sqrt_pd(_mm256_max_pd(disc, zero));
+        __m256d negQb = _mm256_xor_pd(qb, signMask);
+        __m256d rootEnter = _mm256_div_pd(_mm256_sub_pd(negQb, root), qa);
+        __m256d rootExit = _mm256_div_pd(_mm256_add_pd(negQb, root), qa);
+
+        __m256d qaZero = _mm256_cmp_pd(qa, zero, _CMP_EQ_OQ);
+        __m256d qcNegative = _mm256_cmp_pd(qc, zero, _CMP_LT_OQ);
+        __m256d discPositive = _mm256_cmp_pd(disc, zero, _CMP_GT_OQ);
+        __m256d hEnter = _mm256_blendv_pd(_mm256_blendv_pd(inf, rootEnter, discPositive),
+                                          _mm256_blendv_pd(inf, negInf, qcNegative), qaZero);
+        __m256d hExit = _mm256_blendv_pd(_mm256_blendv_pd(negInf, rootExit, discPositive),
+                                         _mm256_blendv_pd(negInf, inf, qcNegative), qaZero);
+
+        // Vertical interval
+        __m256d vzZero = _mm256_cmp_pd(rvz, zero, _CMP_EQ_OQ);
+        __m256d inside = _mm256_cmp_pd(_mm256_andnot_pd(signMask, pz), vSep, _CMP_LT_OQ);
+        __m256d t0 = _mm256_div_pd(_mm256_sub_pd(negVSep, pz), rvz);
+        __m256d t1 = _mm256_div_pd(_mm256_sub_pd(vSep, pz), rvz);
+        __m256d vEnter = _mm256_blendv_pd(_mm256_min_pd(t0, t1), _mm256_blendv_pd(inf, negInf, inside), vzZero);
+        __m256d vExit = _mm256_blendv_pd(_mm256_max_pd(t0, t1), _mm256_blendv_pd(negInf, inf, inside), vzZero);
+
+        __m256d enter = _mm256_max_pd(zero, _mm256_max_pd(hEnter, vEnter));
+        __m256d exit = _mm256_min_pd(window, _mm256_min_pd(hExit, vExit));
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(enter, exit, _CMP_LT_OQ));
+        while (mask) {
+            hits[count++] = j + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    // Remaining 0-3 entries
+    return count + separationKernelScalar(soa, a, j, end, lookahead, hits + count);
+}
+#endif
+
+} // namespace
+
+KernelIsa detectKernelIsa() {
+#ifdef SEPARATION_KERNEL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KernelIsa::AVX2;
+    }
+#endif
+    return KernelIsa::SCALAR;
+}
+
+const char* kernelIsaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::AVX2:   return "AVX2";
+        case KernelIsa::SCALAR: return "scalar";
+        default:                return "unknown";
+    }
+}
+
+size_t separationKernel(KernelIsa isa, const AircraftSoA& soa, uint32_t a,
+                        uint32_t begin, uint32_t end, double lookahead, uint32_t* hits) {
+#ifdef SEPARATION_KERNEL_AVX2
+    if (isa == KernelIsa::AVX2) {
+        return separationKernelAvx2(soa, a, begin, end, lookahead, hits);
+    }
+#endif
+    return separationKernelScalar(soa, a, begin, end, lookahead, hits);
+}
@@ -0,0 +1,183 @@
+// SimClock.cpp
+#include "SimClock.h"
+#include "Logger.h"
+#include <cerrno>
+
+SimClock::SimClock()
+    : mode_(Mode::REALTIME), speedup_(1.0), timestep_(1.0), running_(false), tick_(0), stopped_(false), completedTick_(0),
+      phase_(PHASE_COUNT), pending_(0) {
+    pthread_mutex_init(&mutex_, nullptr);
+    pthread_cond_init(&phaseCond_, nullptr);
+    pthread_cond_init(&doneCond_, nullptr);
+}
+
+SimClock::~SimClock() {
+    stop();
+    pthread_cond_destroy(&doneCond_);
+    pthread_cond_destroy(&phaseCond_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+void SimClock::configure(Mode mode, double speedup, double timestep) {
+    if (running_) {
+        LOG_ERROR("SimClock", "Cannot reconfigure a running clock");
+        return;
+    }
+    mode_ = mode;
+    speedup_ = (mode == Mode::ACCELERATED && speedup > 0.0) ? speedup : 1.0;
+    timestep_ = timestep > 0.0 ? timestep : 1.0;
+}
+
+void SimClock::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    int ret = pthread_create(&thread_, nullptr, SimClock::threadFunc, this);
+    if (ret != 0) {
+        LOG_ERROR("SimClock", "Failed to create clock thread");
+        exit(EXIT_FAILURE);
+    }
+    const char* mode = mode_ == Mode::REALTIME ? "real time"
+                     : mode_ == Mode::ACCELERATED ? "accelerated"
+                     : "as fast as possible";
+    LOG_INFO("SimClock", std::string("Clock started, ") + mode + ", x" + std::to_string(speedup_)
+             + ", timestep " + std::to_string(timestep_) + "s");
+}
+
+void SimClock::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    pthread_mutex_lock(&mutex_);
+    stopped_ = true;
+    pthread_cond_broadcast(&phaseCond_);
+    pthread_cond_broadcast(&doneCond_);
+    pthread_mutex_unlock(&mutex_);
+    pthread_join(thread_, nullptr);
+    LOG_INFO("SimClock", "Clock stopped at tick " + std::to_string(tick_));
+}
+
+int SimClock::attach(Phase phase) {
+    pthread_mutex_lock(&mutex_);
+    // Joins from the next tick on, so a running phase never waits for it
+    participants_.push_back({ phase, true, tick_ });
+    int id = static_cast<int>(participants_.size() - 1);
+    pthread_mutex_unlock(&mutex_);
+    return id;
+}
+
+void SimClock::detach(int participant) {
+    pthread_mutex_lock(&mutex_);
+    Participant& p = participants_[participant];
+    if (p.attached) {
+        p.attached = false;
+        if (phase_ == p.phase && p.doneTick != tick_) {
+            --pending_;
+            pthread_cond_broadcast(&doneCond_);
+        }
+        pthread_cond_broadcast(&phaseCond_);
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool SimClock::awaitTick(int participant, uint64_t& tick) {
+    pthread_mutex_lock(&mutex_);
+    while (true) {
+        const Participant& p = participants_[participant];
+        if (stopped_ || !p.attached) {
+            pthread_mutex_unlock(&mutex_);
+            return false;
+        }
+        if (phase_ == p.phase && p.doneTick != tick_) {
+            break;
+        }
+        pthread_cond_wait(&phaseCond_, &mutex_);
+    }
+    tick = tick_;
+    pthread_mutex_unlock(&mutex_);
+    return true;
+}
+
+void SimClock::complete(int participant) {
+    pthread_mutex_lock(&mutex_);
+    Participant& p = participants_[participant];
+    if (p.attached && phase_ == p.phase && p.doneTick != tick_) {
+        p.doneTick = tick_;
+        --pending_;
+        pthread_cond_broadcast(&doneCond_);
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool SimClock::waitUntil(double seconds) {
+    pthread_mutex_lock(&mutex_);
+    while (!stopped_ && completedTick_ * timestep_ < seconds) {
+        pthread_cond_wait(&doneCond_, &mutex_);
+    }
+    bool reached = completedTick_ * timestep_ >= seconds;
+    pthread_mutex_unlock(&mutex_);
+    return reached;
+}
+
+void* SimClock::threadFunc(void* arg) {
+    SimClock* self = static_cast<SimClock*>(arg);
+    self->run();
+    return nullptr;
+}
+
+void SimClock::run() {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t ticks = 0;
+
+    while (running_) {
+        pthread_mutex_lock(&mutex_);
+        ++tick_;
+        for (uint32_t phase = 0; phase < PHASE_COUNT && running_; ++phase) {
+            runPhase(static_cast<Phase>(phase));
+        }
+        phase_ = PHASE_COUNT;
+        if (running_) {
+            completedTick_ = tick_;
+        }
+        // Wakes waitUntil() once the whole tick is done
+        pthread_cond_broadcast(&doneCond_);
+        pthread_mutex_unlock(&mutex_);
+
+        pace(start, ++ticks);
+    }
+}
+
+void SimClock::runPhase(Phase phase) {
+    pending_ = 0;
+    for (const auto& p : participants_) {
+        if (p.attached && p.phase == phase && p.doneTick != tick_) {
+            ++pending_;
+        }
+    }
+    if (pending_ == 0) {
+        return;
+    }
+    phase_ = phase;
+    pthread_cond_broadcast(&phaseCond_);
+    while (running_ && pending_ > 0) {
+        pthread_cond_wait(&doneCond_, &mutex_);
+    }
+}
+
+void SimClock::pace(const struct timespec& start, uint64_t ticks) {
+    if (mode_ == Mode::AS_FAST_AS_POSSIBLE) {
+        return;
+    }
+    // Absolute deadlines so per-tick overruns do not accumulate drift
+    double elapsed = ticks * timestep_ / speedup_;
+    struct timespec deadline = start;
+    deadline.tv_sec += static_cast<time_t>(elapsed);
+    deadline.tv_nsec += static_cast<long>((elapsed - static_cast<time_t>(elapsed)) * 1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while (running_ && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
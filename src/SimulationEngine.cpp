@@ -0,0 +1,366 @@
+// SimulationEngine.cpp
+#include "SimulationEngine.h"
+#include "PlaneStateTable.h"
+#include "SimClock.h"
+#include "messages.h"
+#include "Logger.h"
+#include <sys/neutrino.h>
+#include <iostream>
+
+SimulationEngine::SimulationEngine() : running_(false), clockId_(-1) {
+    query_chid_ = ChannelCreate(0);
+    if (query_chid_ == -1) {
+        LOG_ERROR("SimulationEngine", "Failed to create query channel");
+        exit(EXIT_FAILURE);
+    }
+    correction_chid_ = ChannelCreate(0);
+    if (correction_chid_ == -1) {
+        LOG_ERROR("SimulationEngine", "Failed to create course correction channel");
+        exit(EXIT_FAILURE);
+    }
+}
+
+SimulationEngine::~SimulationEngine() {
+    stop();
+}
+
+void SimulationEngine::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    clockId_ = SimClock::getInstance().attach(SimClock::SIMULATION);
+    int ret = pthread_create(&tick_thread_, nullptr, SimulationEngine::tickThreadFunc, this);
+    if (ret != 0) {
+        LOG_ERROR("SimulationEngine", "Failed to create integrator thread");
+        exit(EXIT_FAILURE);
+    }
+    ret = pthread_create(&query_thread_, nullptr, SimulationEngine::queryThreadFunc, this);
+    if (ret != 0) {
+        LOG_ERROR("SimulationEngine", "Failed to create query thread");
+        exit(EXIT_FAILURE);
+    }
+    ret = pthread_create(&correction_thread_, nullptr, SimulationEngine::correctionThreadFunc, this);
+    if (ret != 0) {
+        LOG_ERROR("SimulationEngine", "Failed to create course correction thread");
+        exit(EXIT_FAILURE);
+    }
+    LOG_INFO("SimulationEngine", "Simulation engine started");
+}
+
+void SimulationEngine::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    SimClock::getInstance().detach(clockId_);
+    ChannelDestroy(query_chid_);
+    ChannelDestroy(correction_chid_);
+    pthread_join(tick_thread_, nullptr);
+    pthread_join(query_thread_, nullptr);
+    pthread_join(correction_thread_, nullptr);
+    // O(n), so only once rather than every tick
+    LOG_INFO("SimulationEngine", "Simulation engine stopped, state digest " + std::to_string(stateDigest()));
+}
+
+bool SimulationEngine::add(uint32_t handle, const Vector& position, const Vector& velocity) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (index_.find(handle) != HandleIndex::NONE) {
+        return false;
+    }
+    index_.set(handle, static_cast<uint32_t>(handles_.size()));
+    x_.push_back(position.x);
+    y_.push_back(position.y);
+    z_.push_back(position.z);
+    vx_.push_back(velocity.x);
+    vy_.push_back(velocity.y);
+    vz_.push_back(velocity.z);
+    handles_.push_back(handle);
+    stateTables_.push_back(nullptr);
+    stateSlots_.push_back(-1);
+    return true;
+}
+
+void SimulationEngine::remove(uint32_t handle) {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint32_t slot = index_.find(handle);
+    if (slot == HandleIndex::NONE) {
+        return;
+    }
+    // Swap with the last aircraft to keep the columns dense
+    uint32_t last = static_cast<uint32_t>(handles_.size() - 1);
+    if (slot != last) {
+        x_[slot] = x_[last];
+        y_[slot] = y_[last];
+        z_[slot] = z_[last];
+        vx_[slot] = vx_[last];
+        vy_[slot] = vy_[last];
+        vz_[slot] = vz_[last];
+        handles_[slot] = handles_[last];
+        stateTables_[slot] = stateTables_[last];
+        stateSlots_[slot] = stateSlots_[last];
+        index_.set(handles_[slot], slot);
+    }
+    x_.pop_back();
+    y_.pop_back();
+    z_.pop_back();
+    vx_.pop_back();
+    vy_.pop_back();
+    vz_.pop_back();
+    handles_.pop_back();
+    stateTables_.pop_back();
+    stateSlots_.pop_back();
+    index_.erase(handle);
+}
+
+bool SimulationEngine::contains(uint32_t handle) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return index_.find(handle) != HandleIndex::NONE;
+}
+
+size_t SimulationEngine::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return handles_.size();
+}
+
+bool SimulationEngine::getState(uint32_t handle, Vector& position, Vector& velocity) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint32_t slot = index_.find(handle);
+    if (slot == HandleIndex::NONE) {
+        return false;
+    }
+    position = Vector(x_[slot], y_[slot], z_[slot]);
+    velocity = Vector(vx_[slot], vy_[slot], vz_[slot]);
+    return true;
+}
+
+void SimulationEngine::setVelocity(uint32_t handle, const Vector& velocity) {
+    enqueue({ CommandType::SET_VELOCITY, handle, velocity });
+}
+
+void SimulationEngine::setPosition(uint32_t handle, const Vector& position) {
+    enqueue({ CommandType::SET_POSITION, handle, position });
+}
+
+void SimulationEngine::enqueue(const Command& command) {
+    std::lock_guard<std::mutex> lock(commandMtx);
+    commands_.push_back(command);
+}
+
+Vector SimulationEngine::advance(uint32_t handle, double step) {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint32_t slot = index_.find(handle);
+    if (slot == HandleIndex::NONE) {
+        return Vector();
+    }
+    x_[slot] += vx_[slot] * step;
+    y_[slot] += vy_[slot] * step;
+    z_[slot] += vz_[slot] * step;
+    publish(slot);
+    return Vector(x_[slot], y_[slot], z_[slot]);
+}
+
+void SimulationEngine::setStateSlot(uint32_t handle, PlaneStateTable* table, int stateSlot) {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint32_t slot = index_.find(handle);
+    if (slot == HandleIndex::NONE) {
+        return;
+    }
+    stateTables_[slot] = table;
+    stateSlots_[slot] = stateSlot;
+    publish(slot);
+}
+
+void SimulationEngine::publish(uint32_t slot) {
+    if (stateTables_[slot] != nullptr && stateSlots_[slot] >= 0) {
+        stateTables_[slot]->publish(stateSlots_[slot],
+                                    Vector(x_[slot], y_[slot], z_[slot]),
+                                    Vector(vx_[slot], vy_[slot], vz_[slot]));
+    }
+}
+
+void SimulationEngine::tick(double step) {
+    {
+        std::lock_guard<std::mutex> lock(commandMtx);
+        pending_.swap(commands_);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    applyCommands();
+    integrate(step);
+    for (uint32_t slot = 0; slot < handles_.size(); ++slot) {
+        publish(slot);
+    }
+    LOG_EVENT(DEBUG, SIMULATION_TICK, handles_.size());
+    logPositions();
+}
+
+void SimulationEngine::applyCommands() {
+    for (const auto& command : pending_) {
+        uint32_t slot = index_.find(command.handle);
+        if (slot == HandleIndex::NONE) {
+            continue; // Removed since the command was queued
+        }
+        if (command.type == CommandType::SET_VELOCITY) {
+            vx_[slot] = command.value.x;
+            vy_[slot] = command.value.y;
+            vz_[slot] = command.value.z;
+        } else {
+            x_[slot] = command.value.x;
+            y_[slot] = command.value.y;
+            z_[slot] = command.value.z;
+        }
+    }
+    pending_.clear();
+}
+
+void SimulationEngine::logPositions() const {
+    // One line per aircraft per tick, for tracing ("--log-tag Plane=info");
+    // while the tag is off this costs one check per tick
+    static Logger::TagFilter& filter = Logger::getInstance().tagFilter(logEventFormat(LogEvent::PLANE_POSITION).tag);
+    if (!Logger::compiledIn<Logger::Level::INFO> || !Logger::getInstance().isEnabled(Logger::Level::INFO, filter)) {
+        return;
+    }
+    const AircraftIdTable& ids = AircraftIdTable::getInstance();
+    char id[AircraftIdTable::ID_SIZE];
+    for (uint32_t slot = 0; slot < handles_.size(); ++slot) {
+        ids.name(handles_[slot], id);
+        LOG_EVENT(INFO, PLANE_POSITION, id, x_[slot], y_[slot], z_[slot]);
+    }
+}
+
+uint64_t SimulationEngine::digest() const {
+    // FNV-1a over the raw column bits; equal digests mean bit-identical state
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash = (hash ^ p[i]) * 1099511628211ULL;
+        }
+    };
+    size_t count = handles_.size();
+    mix(handles_.data(), count * sizeof(uint32_t));
+    for (const Column* column : { &x_, &y_, &z_, &vx_, &vy_, &vz_ }) {
+        mix(column->data(), count * sizeof(double));
+    }
+    return hash;
+}
+
+void SimulationEngine::integrate(double step) {
+    // Plain column loops so the compiler can vectorise them
+    size_t count = handles_.size();
+    double* x = x_.data();
+    double* y = y_.data();
+    double* z = z_.data();
+    const double* vx = vx_.data();
+    const double* vy = vy_.data();
+    const double* vz = vz_.data();
+    for (size_t i = 0; i < count; ++i) {
+        x[i] += vx[i] * step;
+        y[i] += vy[i] * step;
+        z[i] += vz[i] * step;
+    }
+}
+
+void* SimulationEngine::tickThreadFunc(void* arg) {
+    static_cast<SimulationEngine*>(arg)->tickLoop();
+    return nullptr;
+}
+
+void* SimulationEngine::queryThreadFunc(void* arg) {
+    static_cast<SimulationEngine*>(arg)->queryLoop();
+    return nullptr;
+}
+
+void* SimulationEngine::correctionThreadFunc(void* arg) {
+    static_cast<SimulationEngine*>(arg)->correctionLoop();
+    return nullptr;
+}
+
+void SimulationEngine::tickLoop() {
+    SimClock& clock = SimClock::getInstance();
+    uint64_t tickNumber;
+    while (running_ && clock.awaitTick(clockId_, tickNumber)) {
+        tick(clock.getTimestep());
+        clock.complete(clockId_);
+    }
+}
+
+void SimulationEngine::queryLoop() {
+    RadarQueryMsg queryMsg;
+    while (running_) {
+        int rcvid = MsgReceive(query_chid_, &queryMsg, sizeof(queryMsg), NULL);
+        if (rcvid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (rcvid == 0) {
+            continue;
+        }
+
+        uint32_t handle = static_cast<uint32_t>(queryMsg.aircraft_id);
+        PlaneResponseMsg responseMsg;
+        Vector position, velocity;
+        if (!getState(handle, position, velocity)) {
+            MsgError(rcvid, ENOENT);
+            continue;
+        }
+        static_assert(sizeof(responseMsg.data.id) == AircraftIdTable::ID_SIZE, "reply id must hold an interned id");
+        AircraftIdTable::getInstance().name(handle, responseMsg.data.id);
+        responseMsg.data.x = position.x;
+        responseMsg.data.y = position.y;
+        responseMsg.data.z = position.z;
+        responseMsg.data.speedX = velocity.x;
+        responseMsg.data.speedY = velocity.y;
+        responseMsg.data.speedZ = velocity.z;
+        MsgReply(rcvid, EOK, &responseMsg, sizeof(responseMsg));
+    }
+}
+
+void SimulationEngine::correctionLoop() {
+    std::vector<CourseCorrectionMsg> corrections;
+    while (running_) {
+        // Only the header is received here, the records are pulled with MsgRead
+        union {
+            struct _pulse pulse;
+            CourseCorrectionHeader header;
+        } msg;
+        int rcvid = MsgReceive(correction_chid_, &msg, sizeof(msg), NULL);
+        if (rcvid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("SimulationEngine", "Failed to receive course correction");
+            break;
+        }
+        if (rcvid == 0) {
+            continue;
+        }
+
+        corrections.resize(msg.header.count);
+        size_t bytes = corrections.size() * sizeof(CourseCorrectionMsg);
+        if (bytes > 0) {
+            int read = MsgRead(rcvid, corrections.data(), bytes, sizeof(msg.header));
+            if (read == -1 || static_cast<size_t>(read) != bytes) {
+                MsgError(rcvid, EIO);
+                continue;
+            }
+        }
+
+        // Queue before replying, the clock must not start the next tick
+        // before the commands are queued
+        {
+            std::lock_guard<std::mutex> lock(commandMtx);
+            for (const auto& correction : corrections) {
+                commands_.push_back({ CommandType::SET_VELOCITY, correction.handle, correction.newVelocity });
+            }
+        }
+        MsgReply(rcvid, EOK, nullptr, 0);
+
+        for (const auto& correction : corrections) {
+            std::string id = AircraftIdTable::getInstance().name(correction.handle);
+            LOG_WARNING("Plane", id + " Received Course Correction alert");
+            std::cout << "Plane " << id << " Received Course Correction alert.\n";
+        }
+    }
+}
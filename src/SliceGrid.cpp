@@ -0,0 +1,94 @@
+// SliceGrid.cpp
+#include "SliceGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Cells allowed per aircraft before they are enlarged
+const size_t CELLS_PER_AIRCRAFT = 2;
+}
+
+SliceGrid::SliceGrid() : nx_(0), ny_(0), nz_(0) {}
+
+uint64_t SliceGrid::countPairs() const {
+    uint64_t pairs = 0;
+    forEachSpan([&pairs](uint32_t, uint32_t begin, uint32_t end) {
+        pairs += end - begin;
+    });
+    return pairs;
+}
+
+void SliceGrid::build(const std::vector<PlaneState>& states, double time, double cellXY, double cellZ) {
+    size_t n = states.size();
+    px_.resize(n);
+    py_.resize(n);
+    pz_.resize(n);
+    double low[3] = { 0.0, 0.0, 0.0 };
+    double high[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < n; ++i) {
+        const Vector& p = states[i].position;
+        const Vector& v = states[i].velocity;
+        px_[i] = p.x + v.x * time;
+        py_[i] = p.y + v.y * time;
+        pz_[i] = p.z + v.z * time;
+        double c[3] = { px_[i], py_[i], pz_[i] };
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = i == 0 ? c[axis] : std::min(low[axis], c[axis]);
+            high[axis] = i == 0 ? c[axis] : std::max(high[axis], c[axis]);
+        }
+    }
+
+    // Enlarge the cells evenly until the box fits the cell budget
+    double maxCells = double(std::max<size_t>(n, 16) * CELLS_PER_AIRCRAFT);
+    double cells = 0.0;
+    while (true) {
+        nx_ = static_cast<size_t>((high[0] - low[0]) / cellXY) + 1;
+        ny_ = static_cast<size_t>((high[1] - low[1]) / cellXY) + 1;
+        nz_ = static_cast<size_t>((high[2] - low[2]) / cellZ) + 1;
+        cells = double(nx_) * double(ny_) * double(nz_);
+        if (cells <= maxCells) {
+            break;
+        }
+        double grow = std::max(std::cbrt(cells / maxCells), 1.01);
+        cellXY *= grow;
+        cellZ *= grow;
+    }
+
+    size_t cellCount = static_cast<size_t>(cells);
+    cellOf_.resize(n);
+    cellStart_.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        size_t cx = std::min(static_cast<size_t>((px_[i] - low[0]) / cellXY), nx_ - 1);
+        size_t cy = std::min(static_cast<size_t>((py_[i] - low[1]) / cellXY), ny_ - 1);
+        size_t cz = std::min(static_cast<size_t>((pz_[i] - low[2]) / cellZ), nz_ - 1);
+        cellOf_[i] = static_cast<uint32_t>((cx * ny_ + cy) * nz_ + cz);
+        ++cellStart_[cellOf_[i] + 1];
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        cellStart_[c + 1] += cellStart_[c];
+    }
+
+    // Counting sort, each cell filled in snapshot order
+    order_.resize(n);
+    fill_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        order_[fill_[cellOf_[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    x_.resize(n);
+    y_.resize(n);
+    z_.resize(n);
+    vx_.resize(n);
+    vy_.resize(n);
+    vz_.resize(n);
+    for (size_t e = 0; e < n; ++e) {
+        uint32_t i = order_[e];
+        const Vector& v = states[i].velocity;
+        x_[e] = px_[i];
+        y_[e] = py_[i];
+        z_[e] = pz_[i];
+        vx_[e] = v.x;
+        vy_[e] = v.y;
+        vz_[e] = v.z;
+    }
+}
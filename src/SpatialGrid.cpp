@@ -0,0 +1,112 @@
+// SpatialGrid.cpp
+#include "SpatialGrid.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Each cell coordinate is packed into 21 bits of the key
+constexpr int64_t COORD_BITS = 21;
+constexpr int64_t COORD_OFFSET = int64_t(1) << (COORD_BITS - 1);
+constexpr int64_t COORD_MASK = (int64_t(1) << COORD_BITS) - 1;
+}
+
+SpatialGrid::SpatialGrid() : cellSizeXY_(Separation::HORIZONTAL), cellSizeZ_(Separation::VERTICAL) {}
+
+int64_t SpatialGrid::cellCoord(double value, double cellSize) const {
+    double c = std::floor(value / cellSize);
+    // Clamp so aircraft far outside the airspace still map to a valid key
+    c = std::max(std::min(c, double(COORD_OFFSET - 2)), double(-COORD_OFFSET + 2));
+    return static_cast<int64_t>(c);
+}
+
+uint64_t SpatialGrid::cellKey(int64_t cx, int64_t cy, int64_t cz) const {
+    return (uint64_t((cx + COORD_OFFSET) & COORD_MASK) << (2 * COORD_BITS)) |
+           (uint64_t((cy + COORD_OFFSET) & COORD_MASK) << COORD_BITS) |
+           uint64_t((cz + COORD_OFFSET) & COORD_MASK);
+}
+
+void SpatialGrid::build(const std::vector<PlaneState>& states, double lookahead) {
+    // Worst-case closing speed is twice the fastest aircraft on each axis
+    double maxSpeedXY = 0.0;
+    double maxSpeedZ = 0.0;
+    for (const auto& s : states) {
+        maxSpeedXY = std::max(maxSpeedXY, std::sqrt(s.velocity.x * s.velocity.x + s.velocity.y * s.velocity.y));
+        maxSpeedZ = std::max(maxSpeedZ, std::fabs(s.velocity.z));
+    }
+    cellSizeXY_ = Separation::HORIZONTAL + 2.0 * maxSpeedXY * lookahead;
+    cellSizeZ_ = Separation::VERTICAL + 2.0 * maxSpeedZ * lookahead;
+
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        const Vector& p = states[i].position;
+        uint64_t key = cellKey(cellCoord(p.x, cellSizeXY_),
+                               cellCoord(p.y, cellSizeXY_),
+                               cellCoord(p.z, cellSizeZ_));
+        entries.emplace_back(key, static_cast<uint32_t>(i));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    order_.resize(entries.size());
+    keys_.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        keys_[i] = entries[i].first;
+        order_[i] = entries[i].second;
+    }
+
+    cells_.clear();
+    cellList_.clear();
+    coords_.clear();
+    size_t begin = 0;
+    while (begin < keys_.size()) {
+        size_t end = begin + 1;
+        while (end < keys_.size() && keys_[end] == keys_[begin]) {
+            ++end;
+        }
+        CellRange range = { static_cast<uint32_t>(begin), static_cast<uint32_t>(end) };
+        uint64_t key = keys_[begin];
+        cells_[key] = range;
+        cellList_.push_back(range);
+        coords_.push_back(int64_t((key >> (2 * COORD_BITS)) & COORD_MASK) - COORD_OFFSET);
+        coords_.push_back(int64_t((key >> COORD_BITS) & COORD_MASK) - COORD_OFFSET);
+        coords_.push_back(int64_t(key & COORD_MASK) - COORD_OFFSET);
+        begin = end;
+    }
+}
+
+void SpatialGrid::candidateSpans(std::vector<CandidateSpan>& out) const {
+    for (size_t c = 0; c < cellList_.size(); ++c) {
+        const CellRange& cell = cellList_[c];
+        uint64_t key = keys_[cell.begin];
+        int64_t cx = coords_[3 * c];
+        int64_t cy = coords_[3 * c + 1];
+        int64_t cz = coords_[3 * c + 2];
+
+        // Pairs inside the cell
+        for (uint32_t i = cell.begin; i < cell.end; ++i) {
+            if (i + 1 < cell.end) {
+                out.push_back({ i, i + 1, cell.end });
+            }
+        }
+
+        // Pairs with neighbouring cells; each cell pair is visited once from the lower key
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                for (int64_t dz = -1; dz <= 1; ++dz) {
+                    uint64_t neighbourKey = cellKey(cx + dx, cy + dy, cz + dz);
+                    if (neighbourKey <= key) {
+                        continue;
+                    }
+                    auto it = cells_.find(neighbourKey);
+                    if (it == cells_.end()) {
+                        continue;
+                    }
+                    for (uint32_t i = cell.begin; i < cell.end; ++i) {
+                        out.push_back({ i, it->second.begin, it->second.end });
+                    }
+                }
+            }
+        }
+    }
+}
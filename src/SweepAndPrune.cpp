@@ -0,0 +1,77 @@
+// SweepAndPrune.cpp
+#include "SweepAndPrune.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Widens every interval a little, so rounding never drops a pair on the boundary
+const double EXTENT_MARGIN = 1.0;
+// Moves per aircraft the insertion sort may make before a full sort is cheaper
+const size_t SHIFT_BUDGET = 32;
+}
+
+SweepAndPrune::SweepAndPrune() : shifts_(0), fullSorts_(0) {}
+
+void SweepAndPrune::build(const std::vector<PlaneState>& states, double lookahead) {
+    // |dx| can shrink by at most (|vx_a| + |vx_b|) * lookahead over the window
+    size_t count = states.size();
+    lower_.resize(count);
+    upper_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        double extent = 0.5 * Separation::HORIZONTAL + std::fabs(states[i].velocity.x) * lookahead + EXTENT_MARGIN;
+        lower_[i] = states[i].position.x - extent;
+        upper_[i] = states[i].position.x + extent;
+    }
+
+    shifts_ = 0;
+    if (order_.size() != count) {
+        // Aircraft came or went: the old order no longer lists every index once
+        sortFromScratch();
+    } else {
+        size_t budget = SHIFT_BUDGET * count;
+        for (size_t i = 1; i < count && shifts_ <= budget; ++i) {
+            uint32_t index = order_[i];
+            double key = lower_[index];
+            size_t j = i;
+            while (j > 0 && lower_[order_[j - 1]] > key) {
+                order_[j] = order_[j - 1];
+                --j;
+            }
+            order_[j] = index;
+            shifts_ += i - j;
+        }
+        if (shifts_ > budget) {
+            // Order mostly lost, e.g. indices reused by other aircraft
+            sortFromScratch();
+        }
+    }
+
+    begin_.resize(count);
+    end_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        begin_[i] = lower_[order_[i]];
+        end_[i] = upper_[order_[i]];
+    }
+}
+
+void SweepAndPrune::sortFromScratch() {
+    order_.resize(lower_.size());
+    for (size_t i = 0; i < order_.size(); ++i) {
+        order_[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+        return lower_[a] < lower_[b];
+    });
+    ++fullSorts_;
+}
+
+void SweepAndPrune::candidateSpans(std::vector<CandidateSpan>& out) const {
+    // Later intervals start no earlier, so they overlap exactly while they start before this one ends
+    for (size_t i = 0; i + 1 < order_.size(); ++i) {
+        size_t end = std::lower_bound(begin_.begin() + i + 1, begin_.end(), end_[i]) - begin_.begin();
+        if (end > i + 1) {
+            out.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(i + 1), static_cast<uint32_t>(end) });
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// Timestamp.cpp
+#include "Timestamp.h"
+#include <cstring>
+
+namespace {
+uint64_t realtimeNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+// Last second formatted by this thread
+struct SecondCache {
+    int64_t second = -1;
+    char text[8]; // HH:MM:SS
+};
+thread_local SecondCache cache;
+}
+
+uint64_t Timestamp::wallNanos() {
+    static const uint64_t offset = realtimeNanos() - monotonicNanos();
+    return monotonicNanos() + offset;
+}
+
+size_t Timestamp::format(uint64_t wallNs, char* out) {
+    int64_t second = static_cast<int64_t>(wallNs / 1000000000ULL);
+    if (second != cache.second) {
+        time_t seconds = static_cast<time_t>(second);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        char* text = cache.text;
+        text[0] = static_cast<char>('0' + local.tm_hour / 10);
+        text[1] = static_cast<char>('0' + local.tm_hour % 10);
+        text[2] = ':';
+        text[3] = static_cast<char>('0' + local.tm_min / 10);
+        text[4] = static_cast<char>('0' + local.tm_min % 10);
+        text[5] = ':';
+        // tm_sec can be 60 for a leap second
+        text[6] = static_cast<char>('0' + local.tm_sec / 10);
+        text[7] = static_cast<char>('0' + local.tm_sec % 10);
+        cache.second = second;
+    }
+    memcpy(out, cache.text, sizeof(cache.text));
+    unsigned ms = static_cast<unsigned>(wallNs % 1000000000ULL / 1000000);
+    out[8] = '.';
+    out[9] = static_cast<char>('0' + ms / 100);
+    out[10] = static_cast<char>('0' + ms / 10 % 10);
+    out[11] = static_cast<char>('0' + ms % 10);
+    return TEXT_LENGTH;
+}
+
+std::string Timestamp::now() {
+    char text[TEXT_LENGTH];
+    return std::string(text, now(text));
+}
@@ -0,0 +1,156 @@
+// WorkerPool.cpp
+#include "WorkerPool.h"
+#include "Logger.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t workers)
+    : workerCount_(std::max<size_t>(workers, 1)), slices_(new Slice[std::max<size_t>(workers, 1)]),
+      generation_(0), busyWorkers_(0), running_(true), task_(nullptr), grain_(1) {
+    pthread_mutex_init(&mutex_, nullptr);
+    pthread_cond_init(&startCond_, nullptr);
+    pthread_cond_init(&doneCond_, nullptr);
+
+    for (size_t w = 0; w < workerCount_; ++w) {
+        slices_[w].bounds.store(pack(0, 0));
+    }
+
+    // Worker 0 is the thread calling parallelFor
+    args_.resize(workerCount_);
+    threads_.resize(workerCount_ - 1);
+    for (size_t w = 1; w < workerCount_; ++w) {
+        args_[w] = { this, w };
+        int ret = pthread_create(&threads_[w - 1], nullptr, WorkerPool::threadFunc, &args_[w]);
+        if (ret != 0) {
+            LOG_ERROR("WorkerPool", "Failed to create worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    pthread_mutex_lock(&mutex_);
+    running_ = false;
+    pthread_cond_broadcast(&startCond_);
+    pthread_mutex_unlock(&mutex_);
+
+    for (auto& thread : threads_) {
+        pthread_join(thread, nullptr);
+    }
+
+    pthread_cond_destroy(&doneCond_);
+    pthread_cond_destroy(&startCond_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+void* WorkerPool::threadFunc(void* arg) {
+    ThreadArg* self = static_cast<ThreadArg*>(arg);
+    self->pool->workerLoop(self->worker);
+    return nullptr;
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grain, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+    if (workerCount_ == 1) {
+        task(0, count, 0);
+        return;
+    }
+
+    // Hand out equal contiguous slices; stealing evens out the rest
+    for (size_t w = 0; w < workerCount_; ++w) {
+        uint32_t begin = static_cast<uint32_t>(count * w / workerCount_);
+        uint32_t end = static_cast<uint32_t>(count * (w + 1) / workerCount_);
+        slices_[w].bounds.store(pack(begin, end));
+    }
+
+    pthread_mutex_lock(&mutex_);
+    task_ = &task;
+    grain_ = static_cast<uint32_t>(std::max<size_t>(grain, 1));
+    busyWorkers_ = workerCount_ - 1;
+    ++generation_;
+    pthread_cond_broadcast(&startCond_);
+    pthread_mutex_unlock(&mutex_);
+
+    work(0);
+
+    pthread_mutex_lock(&mutex_);
+    while (busyWorkers_ > 0) {
+        pthread_cond_wait(&doneCond_, &mutex_);
+    }
+    task_ = nullptr;
+    pthread_mutex_unlock(&mutex_);
+}
+
+void WorkerPool::workerLoop(size_t worker) {
+    uint64_t seen = 0;
+    while (true) {
+        pthread_mutex_lock(&mutex_);
+        while (running_ && generation_ == seen) {
+            pthread_cond_wait(&startCond_, &mutex_);
+        }
+        if (!running_) {
+            pthread_mutex_unlock(&mutex_);
+            break;
+        }
+        seen = generation_;
+        pthread_mutex_unlock(&mutex_);
+
+        work(worker);
+
+        pthread_mutex_lock(&mutex_);
+        if (--busyWorkers_ == 0) {
+            pthread_cond_signal(&doneCond_);
+        }
+        pthread_mutex_unlock(&mutex_);
+    }
+}
+
+void WorkerPool::work(size_t worker) {
+    uint32_t begin, end;
+    do {
+        while (takeOwn(worker, begin, end)) {
+            (*task_)(begin, end, worker);
+        }
+    } while (steal(worker));
+}
+
+bool WorkerPool::takeOwn(size_t worker, uint32_t& begin, uint32_t& end) {
+    std::atomic<uint64_t>& bounds = slices_[worker].bounds;
+    uint64_t current = bounds.load();
+    while (true) {
+        uint32_t b = static_cast<uint32_t>(current >> 32);
+        uint32_t e = static_cast<uint32_t>(current);
+        if (b >= e) {
+            return false;
+        }
+        uint32_t next = std::min(e, b + grain_);
+        if (bounds.compare_exchange_weak(current, pack(next, e))) {
+            begin = b;
+            end = next;
+            return true;
+        }
+    }
+}
+
+bool WorkerPool::steal(size_t thief) {
+    for (size_t offset = 1; offset < workerCount_; ++offset) {
+        size_t victim = (thief + offset) % workerCount_;
+        std::atomic<uint64_t>& bounds = slices_[victim].bounds;
+        uint64_t current = bounds.load();
+        while (true) {
+            uint32_t b = static_cast<uint32_t>(current >> 32);
+            uint32_t e = static_cast<uint32_t>(current);
+            if (b >= e) {
+                break;
+            }
+            // Take the back half, or everything if only one chunk is left
+            uint32_t mid = (e - b <= grain_) ? b : b + (e - b) / 2;
+            if (bounds.compare_exchange_weak(current, pack(b, mid))) {
+                slices_[thief].bounds.store(pack(mid, e));
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,87 @@
+// AircraftIdTable.h
+#ifndef AIRCRAFTIDTABLE_H
+#define AIRCRAFTIDTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+// Interns the 16-byte aircraft id strings into dense integer handles
+// (0, 1, 2, ...) shared by the radar and the computer system. Ids are
+// looked up in an open-addressing hash table with linear probing, so a
+// lookup is a hash plus a few 16-byte compares and never allocates.
+class AircraftIdTable {
+public:
+    static constexpr uint32_t INVALID_HANDLE = 0xFFFFFFFFu;
+    static constexpr size_t ID_SIZE = 16;
+
+    static AircraftIdTable& getInstance() {
+        static AircraftIdTable instance;
+        return instance;
+    }
+
+    // Returns the handle of 'id', creating one if it was never seen
+    uint32_t intern(const char* id);
+    uint32_t intern(const std::string& id) { return intern(id.c_str()); }
+
+    // Returns INVALID_HANDLE for unknown ids
+    uint32_t find(const char* id) const;
+    uint32_t find(const std::string& id) const { return find(id.c_str()); }
+
+    std::string name(uint32_t handle) const;
+    // Copies the id into 'out' (ID_SIZE bytes, always terminated) without allocating
+    void name(uint32_t handle, char* out) const;
+    size_t size() const;
+
+private:
+    struct Key {
+        char bytes[ID_SIZE]; // Zero padded after the terminator
+    };
+
+    AircraftIdTable();
+    ~AircraftIdTable();
+    AircraftIdTable(const AircraftIdTable&) = delete;
+    AircraftIdTable& operator=(const AircraftIdTable&) = delete;
+
+    static Key makeKey(const char* id);
+    static uint64_t hash(const Key& key);
+    uint32_t probe(const Key& key, uint64_t h) const; // Caller holds lock_
+    void grow();
+
+    std::vector<uint32_t> buckets_; // Handle or INVALID_HANDLE, size is a power of two
+    std::vector<Key> keys_;         // Indexed by handle
+    mutable pthread_rwlock_t lock_;
+};
+
+// Direct-mapped index from dense handle to a position in some container.
+// Because handles are dense this is a perfect hash: one array load per lookup.
+class HandleIndex {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    uint32_t find(uint32_t handle) const {
+        return handle < slots_.size() ? slots_[handle] : NONE;
+    }
+
+    void set(uint32_t handle, uint32_t slot) {
+        if (handle >= slots_.size()) {
+            slots_.resize(handle + 1, NONE);
+        }
+        slots_[handle] = slot;
+    }
+
+    void erase(uint32_t handle) {
+        if (handle < slots_.size()) {
+            slots_[handle] = NONE;
+        }
+    }
+
+    void clear() { slots_.assign(slots_.size(), NONE); }
+
+private:
+    std::vector<uint32_t> slots_;
+};
+
+#endif // AIRCRAFTIDTABLE_H
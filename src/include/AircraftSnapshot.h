@@ -0,0 +1,93 @@
+// AircraftSnapshot.h
+#ifndef AIRCRAFTSNAPSHOT_H
+#define AIRCRAFTSNAPSHOT_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "AircraftIdTable.h"
+#include "KdTree.h"
+#include "messages.h"
+
+// One radar frame's view of the airspace. Never modified once published.
+struct AircraftSnapshot {
+    uint32_t frame = 0;             // Radar frames received, identifies the snapshot
+    double time = 0.0;              // Simulated seconds since the first frame
+    std::vector<PlaneState> states;
+    std::vector<uint32_t> handles;  // handles[i] is the aircraft of states[i]
+    HandleIndex index;              // handle -> position in states
+
+    // What the frame changed relative to the previous snapshot
+    std::vector<uint32_t> touched;  // Added or corrected by the radar
+    std::vector<uint32_t> dropped;  // No longer tracked
+
+    KdTree spatialIndex;            // Over states, for radius, box and nearest queries
+
+    uint32_t indexOf(uint32_t handle) const { return index.find(handle); }
+};
+
+// Single writer, many readers. The writer fills a snapshot and swaps it in
+// with one atomic store; readers never lock or copy. A replaced snapshot is
+// reclaimed (and recycled for a later frame) once no reader that could have
+// seen it is still inside a read section, tracked with a global epoch.
+class AircraftSnapshots {
+public:
+    // Read section; keeps its snapshot alive until destroyed
+    class Reader {
+    public:
+        explicit Reader(AircraftSnapshots& snapshots);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const AircraftSnapshot& operator*() const { return *snapshot_; }
+        const AircraftSnapshot* operator->() const { return snapshot_; }
+
+    private:
+        AircraftSnapshots& snapshots_;
+        size_t slot_;
+        const AircraftSnapshot* snapshot_;
+    };
+
+    AircraftSnapshots();
+    ~AircraftSnapshots();
+    AircraftSnapshots(const AircraftSnapshots&) = delete;
+    AircraftSnapshots& operator=(const AircraftSnapshots&) = delete;
+
+    // Writer only: a snapshot to fill, recycled from a reclaimed one if possible
+    AircraftSnapshot* writable();
+    // Writer only: makes 'snapshot' current and retires the previous one
+    void publish(AircraftSnapshot* snapshot);
+
+    size_t getRetiredCount() const { return retired_.size(); }
+
+private:
+    static constexpr size_t READER_SLOTS = 64;
+    static constexpr uint64_t IDLE = 0;
+
+    // One cache line per reader so readers do not contend with each other
+    struct ReaderSlot {
+        std::atomic<uint64_t> epoch; // Epoch at entry, IDLE outside a read section
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    struct Retired {
+        AircraftSnapshot* snapshot;
+        uint64_t epoch; // Readers that entered at this epoch or later cannot see it
+    };
+
+    size_t enter();
+    void leave(size_t slot);
+    void reclaim();
+
+    std::atomic<AircraftSnapshot*> current_;
+    std::atomic<uint64_t> epoch_;
+    ReaderSlot readers_[READER_SLOTS];
+
+    // Writer state
+    std::vector<Retired> retired_;
+    std::vector<AircraftSnapshot*> free_;
+};
+
+#endif // AIRCRAFTSNAPSHOT_H
@@ -0,0 +1,42 @@
+// AircraftSoA.h
+#ifndef AIRCRAFTSOA_H
+#define AIRCRAFTSOA_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "AlignedAllocator.h"
+#include "messages.h"
+
+// Structure-of-arrays mirror of an aircraft snapshot. Entry i of every
+// column describes the snapshot aircraft index(i); the columns are 32-byte
+// aligned so the separation kernel can load several aircraft at once.
+class AircraftSoA {
+public:
+    typedef std::vector<double, AlignedAllocator<double>> Column;
+
+    // Same order as the snapshot
+    void assign(const std::vector<PlaneState>& states);
+    // Reordered, entry i is states[order[i]]
+    void assign(const std::vector<PlaneState>& states, const std::vector<uint32_t>& order);
+
+    size_t size() const { return index_.size(); }
+    uint32_t index(size_t i) const { return index_[i]; }
+
+    const double* x() const { return x_.data(); }
+    const double* y() const { return y_.data(); }
+    const double* z() const { return z_.data(); }
+    const double* vx() const { return vx_.data(); }
+    const double* vy() const { return vy_.data(); }
+    const double* vz() const { return vz_.data(); }
+
+private:
+    void resize(size_t count);
+    void set(size_t i, const PlaneState& state, uint32_t index);
+
+    Column x_, y_, z_;
+    Column vx_, vy_, vz_;
+    std::vector<uint32_t> index_;
+};
+
+#endif // AIRCRAFTSOA_H
@@ -0,0 +1,27 @@
+// AircraftTransfer.h
+#ifndef AIRCRAFTTRANSFER_H
+#define AIRCRAFTTRANSFER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Config.h"
+#include "messages.h"
+
+// Variable-length aircraft list transfer used by computer -> console and
+// computer -> display (the radar sends delta frames, see RadarFrame.h).
+// A reply is an AircraftListHeader followed by exactly header.count
+// PlaneState records, gathered straight from the snapshot so no fixed-size
+// array is copied.
+
+// Pull a snapshot chunk by chunk. 'msg' is the request message to send and
+// 'request' points at its AircraftListRequest, which is updated per chunk.
+// Restarts if the snapshot changes between chunks.
+Status requestAircraftList(int coid, void* msg, size_t msgSize, AircraftListRequest* request,
+                           std::vector<PlaneState>& planes);
+
+// Server side of requestAircraftList
+int replyAircraftList(int rcvid, const AircraftListRequest& request, uint32_t frame,
+                      const std::vector<PlaneState>& planes);
+
+#endif // AIRCRAFTTRANSFER_H
@@ -0,0 +1,12 @@
+// Benchmark.h
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Offline performance runs, started with "atc --benchmark"; results go to stdout.
+// Non-zero when a broad phase, the incremental conflict table or a k-d tree
+// query disagrees with its brute-force reference.
+int runDetectionBenchmark();
+// Log file sink throughput, against opening the file for every line
+int runLoggingBenchmark();
+
+#endif // BENCHMARK_H
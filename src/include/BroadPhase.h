@@ -0,0 +1,37 @@
+// BroadPhase.h
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <cstdint>
+
+// Strategy used to pick the aircraft pairs that get a full separation test
+enum class BroadPhase {
+    BRUTE_FORCE = 0,     // Every pair, reference implementation
+    SPATIAL_GRID = 1,    // Uniform 3D hash grid
+    SWEEP_AND_PRUNE = 2, // Overlapping X intervals, order kept between checks
+    TIME_SLICED = 3      // Grid per short slice of the lookahead, for long horizons
+};
+
+// Pair of indices into an aircraft snapshot, always first < second
+struct CandidatePair {
+    uint32_t first;
+    uint32_t second;
+};
+
+// Aircraft 'a' against the run [begin, end); positions refer to the
+// broad phase's own ordering of the snapshot
+struct CandidateSpan {
+    uint32_t a;
+    uint32_t begin;
+    uint32_t end;
+};
+
+inline bool operator<(const CandidatePair& a, const CandidatePair& b) {
+    return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+inline bool operator==(const CandidatePair& a, const CandidatePair& b) {
+    return a.first == b.first && a.second == b.second;
+}
+
+#endif // BROADPHASE_H
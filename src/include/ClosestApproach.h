@@ -0,0 +1,41 @@
+// ClosestApproach.h
+#ifndef CLOSESTAPPROACH_H
+#define CLOSESTAPPROACH_H
+
+#include <cstddef>
+#include "BroadPhase.h"
+#include "messages.h"
+
+// Closest point of approach of two aircraft on straight-line trajectories,
+// restricted to the window [0, lookahead] seconds from now.
+struct ClosestApproach {
+    double time;               // Time of minimum horizontal separation
+    double horizontalDistance; // Horizontal separation at 'time'
+    double verticalDistance;   // Vertical separation at 'time'
+    double timeToConflict;     // First time both minima are violated, -1 if never
+    bool conflict;             // Separation is lost somewhere in the window
+};
+
+// A pair that loses separation, indices refer to the checked snapshot
+struct Conflict {
+    uint32_t first;
+    uint32_t second;
+    ClosestApproach approach;
+};
+
+// Interval [enter, exit) of [0, lookahead] during which both minima are violated,
+// for relative position p and relative velocity v. Returns false if empty.
+bool conflictWindow(double px, double py, double pz, double vx, double vy, double vz,
+                    double lookahead, double& enter, double& exit);
+
+// Same, with minima 'horizontal' and 'vertical' instead of the Separation ones
+bool conflictWindow(double px, double py, double pz, double vx, double vy, double vz,
+                    double lookahead, double horizontal, double vertical, double& enter, double& exit);
+
+ClosestApproach computeClosestApproach(const PlaneState& a, const PlaneState& b, double lookahead);
+
+// Batch form: results[k] describes states[pairs[k].first] vs states[pairs[k].second]
+void computeClosestApproach(const PlaneState* states, const CandidatePair* pairs, size_t count,
+                            double lookahead, ClosestApproach* results);
+
+#endif // CLOSESTAPPROACH_H
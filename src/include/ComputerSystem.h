@@ -8,6 +8,14 @@
 #include <pthread.h>
 #include "messages.h"
 #include "vector.h"
+#include "ConflictDetector.h"
+#include "ConflictTable.h"
+#include "ConflictResolver.h"
+#include "ConflictAlerts.h"
+#include "LookaheadTiers.h"
+#include "RadarFrame.h"
+#include "CourseCorrection.h"
+#include "AircraftSnapshot.h"
 #include <sys/neutrino.h>
 #include <timer.h>
 
@@ -15,6 +23,15 @@
 // Define pulse codes
 #define PULSE_CODE_EXIT (_PULSE_CODE_MINAVAIL + 1)
 
+// Time from a radar frame arriving to its alerts being sent
+struct DetectionLatencyStats {
+    uint64_t frames = 0; // Frames checked
+    uint64_t alerts = 0; // Conflicts reported over all frames
+    double lastMs = 0.0;
+    double meanMs = 0.0;
+    double maxMs = 0.0;
+};
+
 class ComputerSystem {
 public:
     ComputerSystem();
@@ -28,6 +45,32 @@ public:
     int getOperatorChannelId() const;
     int getDataDisplayChannelId() const;
 
+    // Broad phase of the full check run every frame (SPATIAL_GRID by default)
+    void setBroadPhase(BroadPhase broadPhase);
+    // Re-run every check with BRUTE_FORCE and log any difference
+    void setBroadPhaseCrossCheck(bool enabled);
+
+    // Threads used by the separation checker, including its own
+    void setWorkerCount(size_t workers);
+
+    // Re-evaluate only the pairs affected by each frame instead (off by default)
+    void setIncrementalDetection(bool enabled);
+    // Also run the full detection every frame and log any difference
+    void setIncrementalValidation(bool enabled);
+    // Acceleration bound the incremental checker may assume (units/s^2, default 0)
+    void setMaxAcceleration(double acceleration);
+    // Alert, advisory and strategic horizons; the shortest one is checked and
+    // corrected every frame, the others only report at their own cadence
+    void setLookaheadTiers(const std::vector<LookaheadTier>& tiers);
+    // Alert and correct each conflict once, retrying on timeout (default);
+    // when off every frame re-alerts and re-corrects every conflict
+    void setAlertTracking(bool enabled);
+
+    DetectionLatencyStats getDetectionLatency() const;
+    AlertStats getAlertStats() const;
+    std::vector<TierStats> getTierStats() const;
+    CourseCorrectionStats getCourseCorrectionStats();
+
     void sendPlaneDataToConsole(char planeId[16]);
     void logAirspaceState();
 
@@ -36,23 +79,29 @@ private:
     static void* radarThreadFunc(void* arg);
     static void* operatorThreadFunc(void* arg);
     static void* dataDisplayThreadFunc(void* arg);
+    static void* tierThreadFunc(void* arg);
 
     void run();
     void radarLoop();
     void operatorLoop();
     void dataDisplayLoop();
+    void tierLoop();
 
     //int getPlaneChannelIdById(const std::string& planeId);
-    void sendCourseCorrection(const std::string& planeId, const Vector& velocity, int coid);
+    // Queued until corrections_.flush(), which sends one batch per channel
+    void queueCourseCorrection(const PlaneState& plane, const Vector& velocity);
 
-    // Methods for separation checks and alerts
-    void checkForViolations();
+    // Methods for separation checks and alerts; returns the number of conflicts
+    size_t checkForViolations();
+    // Operator radius, box and nearest queries against the current snapshot
+    void replySpatialQuery(int rcvid, const OperatorCommandMsg& msg);
     void emitAlert(const std::string& message);
 
     pthread_t thread_;          // Main thread for separation checks
     pthread_t radar_thread_;    // Thread for handling radar messages
     pthread_t operator_thread_; // Thread for handling operator messages
     pthread_t dataDisplay_thread_; // Thread for handling DataDisplay requests
+    pthread_t tier_thread_;     // Lower-priority thread for the longer lookahead tiers
     bool running_;
     mutable std::mutex mtx;
 
@@ -61,13 +110,58 @@ private:
     int operator_chid_;
     int dataDisplay_chid_;
 
-    // Data storage
+    // Data storage. The radar thread decodes frames into aircraftStates_ and
+    // publishes a copy per frame; every other reader goes through snapshots_
     std::vector<PlaneState> aircraftStates_;
-    int lookaheadTime_; // 'n' parameter
-
-    // Synchronization
+    uint32_t frame_; // Radar frames received
+    double frameTime_; // Simulated time of the last frame
+    RadarFrameDecoder radarDecoder_;
+    AircraftSnapshots snapshots_;
+    CourseCorrectionSender corrections_; // Connections are dropped with their aircraft
+    std::vector<LookaheadTier> tierConfig_; // Normalized; applied by the tier thread on its next frame
+    bool tiersChanged_;
+    BroadPhase broadPhase_;
+    bool broadPhaseCrossCheck_;
+    size_t workerCount_;
+    bool incrementalDetection_;
+    bool incrementalValidation_;
+    double maxAcceleration_;
+    bool alertTracking_;
+
+    // Separation checker state, only touched by the main thread
+    ConflictDetector detector_;
+    ConflictTable conflictTable_;
+    std::vector<Conflict> conflicts_;
+    std::vector<Conflict> referenceConflicts_; // Incremental validation only
+    ConflictAlerts alerts_;
+    std::vector<Conflict> actionable_; // This frame's conflicts that need a correction
+    ConflictResolver resolver_;
+    std::vector<Resolution> resolutions_;
+
+    // Advisory and strategic tiers, only touched by the tier thread
+    LookaheadTiers tiers_;
+
+    // Spatial query results and scratch, only touched by the operator thread
+    std::vector<uint32_t> queryHits_;
+    std::vector<KdTree::Candidate> queryHeap_;
+    std::vector<PlaneState> queryResults_;
+
+    // Guards the checker settings above
     pthread_mutex_t data_mutex_;
 
+    // Frame hand-off: the radar thread publishes, the checker checks each
+    // frame once and the radar reply waits for it
+    mutable pthread_mutex_t frame_mutex_;
+    pthread_cond_t frameReady_;
+    pthread_cond_t frameChecked_;
+    uint32_t publishedFrame_;
+    uint32_t checkedFrame_;
+    uint64_t frameArrivalNs_;   // CLOCK_MONOTONIC arrival of publishedFrame_
+    DetectionLatencyStats latency_;
+    AlertStats alertStats_;   // Copy of alerts_' counters as of checkedFrame_
+    TierStats alertTier_;     // Recorded by the checker
+    std::vector<TierStats> tierStats_; // Copy of tiers_' statistics, published by the tier thread
+
     // logging
     std::unique_ptr<Timer> airspaceLogTimer;
 
@@ -1,4 +1,3 @@
-
 #ifndef CONFIG_H
 #define CONFIG_H
 #include <string>
@@ -7,4 +6,10 @@ enum Status : int {
     ERROR = -1,
 };
 
-#endif // CONFIG_H
\ No newline at end of file
+// Minimum separation between two aircraft (same units as positions)
+struct Separation {
+    static constexpr double HORIZONTAL = 3000.0;
+    static constexpr double VERTICAL = 1000.0;
+};
+
+#endif // CONFIG_H
@@ -0,0 +1,66 @@
+// ConflictAlerts.h
+#ifndef CONFLICTALERTS_H
+#define CONFLICTALERTS_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "AircraftSnapshot.h"
+#include "ClosestApproach.h"
+
+// Life cycle of one conflicting pair
+enum class AlertState {
+    NEW,          // First reported this frame: alert logged, correction sent
+    ACKNOWLEDGED, // Reported again: nothing logged, correction re-sent on timeout
+    RESOLVING,    // No longer reported, held in case it comes back (-> ACKNOWLEDGED)
+    CLEARED       // Not reported for the whole hold time, then forgotten
+};
+
+struct AlertStats {
+    uint64_t reports = 0;    // Conflicts reported by the checker, over all frames
+    uint64_t raised = 0;     // Alerts logged for new conflicts
+    uint64_t retries = 0;    // Corrections re-sent after the retry timeout
+    uint64_t suppressed = 0; // Reports that needed neither a log line nor a correction
+    uint64_t cleared = 0;
+    size_t active = 0;       // Pairs currently tracked
+    size_t resolving = 0;    // Of those, pairs no longer reported but still held
+};
+
+// Per-pair alert state between frames, keyed by aircraft handles. A conflict
+// is alerted and corrected once; while it keeps being reported it only gets
+// another correction after RETRY_TIMEOUT seconds. A pair that drops out is
+// held for a few seconds before it clears, so a conflict flickering at the
+// edge of the lookahead does not raise a fresh alert each time.
+class ConflictAlerts {
+public:
+    ConflictAlerts();
+
+    // When disabled every report is alerted and corrected, frame after frame
+    void setEnabled(bool enabled);
+
+    // Advances every pair to the snapshot's time given its conflicts, logs
+    // what changed and fills 'actionable' with the conflicts that need a
+    // correction this frame
+    void update(const AircraftSnapshot& snapshot, const std::vector<Conflict>& conflicts,
+                std::vector<Conflict>& actionable);
+
+    const AlertStats& getStats() const { return stats_; }
+
+    static const char* stateName(AlertState state);
+
+private:
+    struct Alert {
+        AlertState state;
+        double lastSeen;       // Simulated time the pair was last reported
+        double lastCorrection; // Simulated time of the last correction
+    };
+
+    static uint64_t pairKey(uint32_t a, uint32_t b);
+
+    bool enabled_;
+    std::unordered_map<uint64_t, Alert> alerts_;
+    AlertStats stats_;
+};
+
+#endif // CONFLICTALERTS_H
@@ -0,0 +1,76 @@
+// ConflictDetector.h
+#ifndef CONFLICTDETECTOR_H
+#define CONFLICTDETECTOR_H
+
+#include <memory>
+#include <vector>
+#include "AircraftSoA.h"
+#include "BroadPhase.h"
+#include "ClosestApproach.h"
+#include "SeparationKernel.h"
+#include "SliceGrid.h"
+#include "SpatialGrid.h"
+#include "SweepAndPrune.h"
+#include "WorkerPool.h"
+#include "messages.h"
+
+// Finds every pair of aircraft predicted to lose separation at any time
+// within the lookahead window. The broad phase only narrows down which pairs
+// are tested; every broad phase must report exactly the same conflicts as
+// BRUTE_FORCE.
+class ConflictDetector {
+public:
+    ConflictDetector();
+
+    void setBroadPhase(BroadPhase broadPhase) { broadPhase_ = broadPhase; }
+    BroadPhase getBroadPhase() const { return broadPhase_; }
+
+    // Defaults to the best ISA the CPU supports
+    void setKernelIsa(KernelIsa isa) { isa_ = isa; }
+    KernelIsa getKernelIsa() const { return isa_; }
+
+    // Number of threads sharing the narrow phase, including the caller.
+    // Results do not depend on the worker count.
+    void setWorkerCount(size_t workers);
+    size_t getWorkerCount() const { return pool_ ? pool_->size() : 1; }
+
+    // When enabled every detection is repeated with BRUTE_FORCE and compared
+    void setCrossCheck(bool enabled) { crossCheck_ = enabled; }
+
+    // Fills 'conflicts' sorted by (first, second)
+    void detect(const std::vector<PlaneState>& states, double lookahead,
+                std::vector<Conflict>& conflicts);
+
+    // True when both lists (sorted by (first, second)) hold the same pairs
+    static bool samePairs(const std::vector<Conflict>& a, const std::vector<Conflict>& b);
+
+private:
+    void detectWith(BroadPhase broadPhase, const std::vector<PlaneState>& states,
+                    double lookahead, std::vector<Conflict>& conflicts);
+    void narrowPhase(const std::vector<PlaneState>& states, double lookahead,
+                     std::vector<Conflict>& conflicts);
+    // TIME_SLICED broad and narrow phase in one, false when the traffic is
+    // too dense for it; see ConflictDetector.cpp
+    bool detectTimeSliced(const std::vector<PlaneState>& states, double lookahead,
+                          std::vector<Conflict>& conflicts);
+
+    // Scratch space owned by one worker, merged after the narrow phase
+    struct WorkerBuffers {
+        std::vector<uint32_t> hits;
+        std::vector<Conflict> conflicts;
+        SliceGrid sliceGrid; // TIME_SLICED only
+    };
+
+    BroadPhase broadPhase_;
+    KernelIsa isa_;
+    bool crossCheck_;
+    SpatialGrid grid_;
+    SweepAndPrune sweep_;
+    AircraftSoA soa_;
+    std::vector<CandidateSpan> spans_;
+    std::unique_ptr<WorkerPool> pool_;
+    std::vector<WorkerBuffers> buffers_;
+    std::vector<Conflict> reference_;
+};
+
+#endif // CONFLICTDETECTOR_H
@@ -0,0 +1,79 @@
+// ConflictResolver.h
+#ifndef CONFLICTRESOLVER_H
+#define CONFLICTRESOLVER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "ClosestApproach.h"
+#include "KdTree.h"
+#include "messages.h"
+#include "vector.h"
+
+// New velocity for one aircraft, index refers to the checked snapshot
+struct Resolution {
+    uint32_t index;
+    Vector velocity;
+};
+
+struct ResolverStats {
+    size_t components = 0;       // Clusters of aircraft linked by conflicts
+    size_t largestComponent = 0; // Aircraft in the largest cluster
+    size_t corrections = 0;
+    size_t unresolved = 0;       // Conflicts no manoeuvre set could clear
+    size_t neighbours = 0;       // Uninvolved aircraft the manoeuvres were checked against
+};
+
+// Turns one frame's conflicts into course corrections. Conflicting aircraft
+// are grouped into connected components of the conflict graph and each
+// component is solved jointly with vertical rate changes: small components
+// exhaustively for the fewest and smallest changes that clear every pair
+// among them, large ones greedily. Every aircraft gets at most one
+// correction per frame. Given the snapshot's k-d tree, a manoeuvre must also
+// keep clear of every other aircraft within reach, so an escape altitude is
+// never one a third aircraft is flying through.
+class ConflictResolver {
+public:
+    // 'conflicts' as reported by ConflictDetector::detect for 'states'.
+    // Fills 'resolutions' with the most urgent component first.
+    void resolve(const std::vector<PlaneState>& states, const std::vector<Conflict>& conflicts,
+                 double lookahead, std::vector<Resolution>& resolutions,
+                 const KdTree* spatialIndex = nullptr);
+
+    const ResolverStats& getStats() const { return stats_; }
+
+private:
+    struct Component {
+        std::vector<uint32_t> members; // Positions in aircraft_
+        double urgency;                // Earliest time to conflict
+    };
+
+    // Aircraft outside the component within reach of a member
+    struct Obstacle {
+        uint32_t index; // Snapshot index
+        uint32_t id;    // Position in aircraft_, NONE if in no conflict
+    };
+
+    uint32_t find(uint32_t id);
+    uint32_t idOf(uint32_t index) const;
+    bool conflictsWith(const std::vector<PlaneState>& states, uint32_t a, uint32_t b, double lookahead) const;
+    void collectObstacles(const std::vector<PlaneState>& states, const Component& component,
+                          const KdTree& spatialIndex, double lookahead);
+    size_t obstacleConflicts(const std::vector<PlaneState>& states, uint32_t id, double lookahead) const;
+    void solveExhaustive(const std::vector<PlaneState>& states, const Component& component, double lookahead);
+    void solveGreedy(const std::vector<PlaneState>& states, const Component& component, double lookahead);
+    size_t conflictsAt(const std::vector<PlaneState>& states, uint32_t id, double lookahead) const;
+
+    std::vector<uint32_t> aircraft_;              // Snapshot indices in any conflict, sorted
+    std::vector<uint32_t> parent_;                // Union-find over aircraft_
+    std::vector<std::vector<uint32_t>> adjacent_; // Conflict graph over aircraft_
+    std::vector<uint8_t> choice_;                 // Manoeuvre per entry of aircraft_
+    std::vector<uint8_t> inComponent_;            // Entries of aircraft_ in the component being solved
+    std::vector<std::vector<Obstacle>> obstacles_; // Per entry of aircraft_, for its component
+    std::vector<uint8_t> blocked_;                // Per member and manoeuvre: runs into an obstacle
+    std::vector<uint32_t> nearby_;
+    std::vector<Component> components_;
+    ResolverStats stats_;
+};
+
+#endif // CONFLICTRESOLVER_H
@@ -0,0 +1,144 @@
+// ConflictTable.h
+#ifndef CONFLICTTABLE_H
+#define CONFLICTTABLE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "AircraftSnapshot.h"
+#include "ClosestApproach.h"
+#include "vector.h"
+
+struct ConflictTableStats {
+    uint64_t frames = 0;
+    uint64_t rebuilds = 0;
+    size_t dirtyAircraft = 0;  // Last frame, changed motion or were added
+    size_t crossedAircraft = 0; // Last frame, only moved to another cell
+    size_t deviatedAircraft = 0; // Last frame, new motion inside the acceleration bound
+    size_t pairsEvaluated = 0; // Last frame
+    size_t trackedPairs = 0;
+};
+
+// Persistent conflict-pair table updated frame by frame. Candidate pairs come
+// from a grid like SpatialGrid's, but kept between frames. Each pair holds a
+// certificate: the earliest time it could lose separation, assuming neither
+// aircraft accelerates harder than the configured bound, or neither changes
+// course where the bound would allow too much drift to certify anything.
+// Pairs live in flat slots linked from both aircraft, and their expiry times
+// in a wheel of short time buckets; a frame only re-evaluates pairs whose
+// certificate expired, pairs of aircraft that left their acceleration
+// envelope, pairs certified straight of aircraft that changed course, and
+// pairs of aircraft that were added or crossed a cell. Reports the same
+// conflicts as ConflictDetector::detect, provided every frame is applied in
+// order.
+class ConflictTable {
+public:
+    ConflictTable();
+
+    // Brings the table up to 'snapshot' and fills 'conflicts' sorted by (first, second)
+    void update(const AircraftSnapshot& snapshot, double lookahead, std::vector<Conflict>& conflicts);
+
+    // Forget everything, the next update starts from scratch
+    void clear();
+
+    // Largest acceleration any aircraft is assumed to keep to between frames.
+    // 0 (the default) treats every velocity change as breaking the pairs'
+    // certificates, which suits aircraft that change course in steps.
+    void setMaxAcceleration(double acceleration);
+    double getMaxAcceleration() const { return maxAcceleration_; }
+
+    const ConflictTableStats& getStats() const { return stats_; }
+
+private:
+    enum class Change {
+        NONE,
+        CROSSED,  // Same straight line, other cell: its existing pairs stay valid
+        DEVIATED, // New motion inside the acceleration envelope: bounded pairs stay valid
+        DIRTY     // Left the envelope: every pair is re-evaluated
+    };
+
+    struct Partner {
+        uint32_t handle;
+        uint32_t pair; // Slot in pairs_
+    };
+
+    struct Track {
+        bool present = false;
+        Change change = Change::NONE;
+        Vector position;  // State at 'time'; the acceleration envelope starts there
+        Vector velocity;
+        double time = 0.0;
+        int64_t cell[3] = { 0, 0, 0 };
+        uint64_t version = 0;          // Invalidates queued cell crossings
+        uint64_t seen = 0;             // Pairing pass that last visited this track
+        std::vector<Partner> partners; // Tracks this one has a pair with
+    };
+
+    struct Pair {
+        uint32_t handle[2];
+        uint32_t at[2];   // Position in each track's partner list
+        uint64_t version; // 0 while the slot is free
+        bool straight;    // Certificate assumes no deviation, see certify()
+    };
+
+    struct Event {
+        double time;
+        uint32_t key;     // Pair slot, or the handle of a cell crossing
+        bool pair;
+        uint64_t version; // Must match the pair's or track's current version
+    };
+
+    static uint64_t pairKey(uint32_t a, uint32_t b);
+    uint64_t cellKey(int64_t cx, int64_t cy, int64_t cz) const;
+    void cellOf(const Vector& position, int64_t cell[3]) const;
+
+    void rebuild(const AircraftSnapshot& snapshot, double lookahead);
+    void mark(uint32_t handle, Change change);
+    Change classify(const Track& track, const PlaneState& state, double now) const;
+    void reanchor(uint32_t handle);
+    // Seconds the pair is certain to stay separated; 'straight' when that
+    // holds only while neither aircraft changes velocity
+    double certify(uint64_t key, const PlaneState& first, const PlaneState& second, bool& straight) const;
+    uint32_t link(uint32_t a, uint32_t b);
+    void unlinkFrom(uint32_t slot, int side);
+    void release(uint32_t slot);
+    void detach(uint32_t handle);
+    void leaveCell(uint32_t handle);
+    void pruneDistantPartners(uint32_t handle);
+    bool adjacent(const Track& a, const Track& b) const;
+    bool place(uint32_t handle, const PlaneState& state, double now); // True if the cell changed
+    void pairWithNeighbours(uint32_t handle, const AircraftSnapshot& snapshot);
+    void evaluate(uint32_t slot, const AircraftSnapshot& snapshot);
+    bool live(const Event& event) const;
+    int64_t wheelSlot(double time) const;
+    void schedule(const Event& event);
+    Track& track(uint32_t handle);
+
+    double lookahead_;
+    double maxAcceleration_;
+    double now_;
+    double cellSpeedXY_;   // Speed bound the cells were sized for
+    double cellSpeedZ_;
+    double cellSizeXY_;
+    double cellSizeZ_;
+    bool valid_;
+    uint64_t serial_;      // Source of versions, never reused
+
+    std::vector<Track> tracks_;                                  // By handle
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;  // Cell key -> handles
+    std::vector<Pair> pairs_;
+    std::vector<uint32_t> freePairs_;
+    std::vector<std::vector<Event>> wheel_; // Events by time bucket, modulo its size
+    int64_t wheelCursor_;                   // Earliest bucket that may hold due events
+
+    // Per-update scratch
+    std::vector<uint32_t> changed_;  // Marked tracks, in marking order
+    std::vector<Event> due_;         // Bucket being drained
+    std::vector<Event> expired_;
+    std::vector<Conflict>* conflicts_;
+
+    ConflictTableStats stats_;
+};
+
+#endif // CONFLICTTABLE_H
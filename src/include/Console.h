@@ -2,6 +2,7 @@
 #define CONSOLE_H
 #include <iostream>
 #include <Config.h>
+#include "messages.h"
 
 class Console {
   public :
@@ -16,11 +17,16 @@ class Console {
     Status updatePlaneVelocity();
     Status listPlanes();
     Status displayPlaneData();
+    Status findPlanesWithinRadius();
+    Status findPlanesInBox();
+    Status findNearestPlanes();
     void displayHelp();
 
    private:
      static void *threadFunc(void *arg);
      void run();
+     Status requestPlanes(OperatorCommandMsg& msg, const std::string& title);
+     Status readVector(const std::string& prompt, Vector& value);
    private:
      pthread_t thread_;
      const int computerSystemCoid_;
@@ -0,0 +1,62 @@
+// CourseCorrection.h
+#ifndef COURSECORRECTION_H
+#define COURSECORRECTION_H
+
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "messages.h"
+#include "vector.h"
+
+struct CourseCorrectionStats {
+    uint64_t messages = 0;    // MsgSend calls that succeeded
+    uint64_t corrections = 0; // Corrections they carried
+};
+
+// Sends course corrections over cached connections. Each aircraft holds a
+// reference to the connection of its correction channel, so aircraft sharing
+// a channel share one connection; it is detached once the last of them is
+// invalidated. Corrections are queued and flush() sends one batch per
+// channel, so a checker cycle costs one MsgSend per channel. Only the checker
+// flushes; other threads queue and ride along with its next batch.
+class CourseCorrectionSender {
+public:
+    CourseCorrectionSender() = default;
+    ~CourseCorrectionSender();
+
+    void queue(uint32_t handle, const Vector& velocity, int chid);
+
+    // Sends everything queued; returns the number of corrections delivered
+    size_t flush();
+
+    // The aircraft is gone, drop its connection reference
+    void invalidate(uint32_t handle);
+
+    CourseCorrectionStats getStats();
+
+private:
+    struct Channel {
+        int coid;
+        uint32_t refs; // Aircraft mapped to this channel
+    };
+
+    struct Pending {
+        int chid;
+        CourseCorrectionMsg msg;
+    };
+
+    int connect(uint32_t handle, int chid); // Caller holds mtx
+    void release(uint32_t handle);          // Caller holds mtx
+    void disconnect(int chid);              // Caller holds mtx
+
+    std::mutex mtx;
+    std::vector<int> aircraftChannel_;          // handle -> chid, -1 when not connected
+    std::unordered_map<int, Channel> channels_; // chid -> connection
+    std::vector<Pending> pending_;
+    std::vector<CourseCorrectionMsg> batch_;
+    CourseCorrectionStats stats_;
+};
+
+#endif // COURSECORRECTION_H
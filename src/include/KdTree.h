@@ -0,0 +1,63 @@
+// KdTree.h
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "messages.h"
+#include "vector.h"
+
+// Static 3D k-d tree over one snapshot's aircraft positions, rebuilt with
+// every radar frame. The tree is implicit: each node is a range of the
+// tree order whose median entry splits it along the axis of largest extent,
+// and ranges of LEAF_SIZE entries or fewer are scanned. Results are
+// snapshot indices.
+class KdTree {
+public:
+    KdTree();
+
+    void build(const std::vector<PlaneState>& states);
+
+    size_t size() const { return entries_.size(); }
+    // Fastest aircraft in the snapshot, bounds how far anyone can travel
+    double getMaxSpeed() const { return maxSpeed_; }
+
+    // Each query replaces the contents of 'out'
+    void withinRadius(const Vector& center, double radius, std::vector<uint32_t>& out) const;
+    void withinBox(const Vector& low, const Vector& high, std::vector<uint32_t>& out) const;
+    // Search state of nearest(), owned by the caller so concurrent readers of
+    // a snapshot never share it and its capacity is kept across queries
+    struct Candidate {
+        double distance2;
+        uint32_t entry;
+        bool operator<(const Candidate& other) const { return distance2 < other.distance2; }
+    };
+
+    // Up to k aircraft closest to 'point', closest first
+    void nearest(const Vector& point, size_t k, std::vector<uint32_t>& out,
+                 std::vector<Candidate>& heap) const;
+
+private:
+    struct Entry {
+        double p[3];
+        uint32_t index; // Snapshot index
+    };
+
+    void buildRange(size_t begin, size_t end);
+    double coord(size_t entry, int axis) const;
+    double distance2(size_t entry, const double point[3]) const;
+    void radiusRange(size_t begin, size_t end, const double center[3], double radius2,
+                     std::vector<uint32_t>& out) const;
+    void boxRange(size_t begin, size_t end, const double low[3], const double high[3],
+                  std::vector<uint32_t>& out) const;
+    void nearestRange(size_t begin, size_t end, const double point[3], size_t k,
+                      std::vector<Candidate>& heap) const;
+    void offer(size_t entry, const double point[3], size_t k, std::vector<Candidate>& heap) const;
+
+    std::vector<Entry> entries_; // Position and snapshot index, in tree order
+    std::vector<uint8_t> axis_;  // Split axis of the node whose median is this entry
+    double maxSpeed_;
+};
+
+#endif // KDTREE_H
@@ -0,0 +1,113 @@
+// LogEvent.h
+#ifndef LOGEVENT_H
+#define LOGEVENT_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Config.h"
+
+// Log lines whose text is produced later. The call site records an event id
+// and its raw arguments; the logger's writer thread, or "atc --decode-log"
+// for a binary log file, turns them into text with the event's format, in
+// which each "{}" takes the next argument. Append new events at the end:
+// binary logs store the id.
+enum class LogEvent : uint16_t {
+    PLANE_POSITION,
+    RADAR_OUT_OF_BOUNDS,
+    RADAR_FRAME_SENT,
+    CONFLICT_ALERT,
+    CONFLICT_RETRY,
+    RESOLVER_CORRECTIONS,
+    RESOLVER_UNRESOLVED,
+    SIMULATION_TICK,
+    COUNT
+};
+
+struct LogEventFormat {
+    const char* tag;
+    const char* format;
+};
+
+// One encoded event, followed by its arguments and LOG_EVENT_END. Each
+// argument is a type byte and its value: 8 bytes for numbers, a length
+// byte and at most 255 characters for strings.
+struct LogEventHeader {
+    uint16_t size;   // Whole record, header and end marker included
+    uint16_t event;
+    uint8_t level;   // Logger::Level
+    uint8_t argc;
+    uint16_t reserved;
+    uint64_t timeNs; // Timestamp::wallNanos()
+};
+
+const uint8_t LOG_EVENT_END = '\n';
+const size_t LOG_EVENT_MAX_ARGS = 8;
+const size_t LOG_EVENT_MAX_STRING = 255;
+const size_t LOG_EVENT_MAX_BYTES = sizeof(LogEventHeader) + LOG_EVENT_MAX_ARGS * (2 + LOG_EVENT_MAX_STRING) + 1;
+
+const LogEventFormat& logEventFormat(LogEvent event);
+
+// Appends "timestamp[ tag] message\n" for the record at 'record' to 'line';
+// false if the record is malformed
+bool formatLogEvent(const char* record, size_t size, std::string& line);
+
+// Prints a binary log file as text, for "atc --decode-log"
+Status decodeLogFile(const std::string& path);
+
+namespace logevent {
+
+enum ArgType : uint8_t { INT = 'i', UINT = 'u', DOUBLE = 'd', STRING = 's' };
+
+inline size_t stringLength(const char* value) {
+    size_t length = 0;
+    while (length < LOG_EVENT_MAX_STRING && value[length] != '\0') {
+        ++length;
+    }
+    return length;
+}
+
+inline char* encodeString(char* out, const char* value, size_t length) {
+    *out++ = STRING;
+    *out++ = static_cast<char>(length);
+    memcpy(out, value, length);
+    return out + length;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, char*>::type encode(char* out, T value) {
+    double raw = value;
+    *out = DOUBLE;
+    memcpy(out + 1, &raw, 8);
+    return out + 9;
+}
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, char*>::type encode(char* out, T value) {
+    int64_t raw = value;
+    *out = INT;
+    memcpy(out + 1, &raw, 8);
+    return out + 9;
+}
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, char*>::type encode(char* out, T value) {
+    uint64_t raw = value;
+    *out = UINT;
+    memcpy(out + 1, &raw, 8);
+    return out + 9;
+}
+inline char* encode(char* out, const char* value) { return encodeString(out, value, stringLength(value)); }
+inline char* encode(char* out, const std::string& value) {
+    return encodeString(out, value.data(), value.size() < LOG_EVENT_MAX_STRING ? value.size() : LOG_EVENT_MAX_STRING);
+}
+
+inline char* encodeArgs(char* out) { return out; }
+template <typename T, typename... Rest>
+char* encodeArgs(char* out, const T& first, const Rest&... rest) {
+    return encodeArgs(encode(out, first), rest...);
+}
+
+} // namespace logevent
+
+#endif // LOGEVENT_H
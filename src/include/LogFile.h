@@ -0,0 +1,67 @@
+// LogFile.h
+#ifndef LOGFILE_H
+#define LOGFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Config.h"
+
+struct LogFileStats {
+    uint64_t bytes = 0;       // Written to disk, over all files
+    uint64_t flushes = 0;     // write() calls
+    uint64_t rotations = 0;
+    double writeSeconds = 0.0; // Spent inside write()
+    double mbPerSecond() const { return writeSeconds > 0.0 ? bytes / writeSeconds / 1e6 : 0.0; }
+};
+
+// Long-lived log file written through a large user-space buffer. The buffer
+// goes out in one write() when it fills or when flushIfDue() finds it older
+// than FLUSH_INTERVAL. Once a file reaches its size limit it is renamed to
+// path.1 (path.1 to path.2 and so on, keeping 'keep' old files) and writing
+// continues in a file preallocated ahead of time, so rotation is a rename
+// rather than a create plus block allocation on the logging path.
+// Preallocated space past the written end is trimmed on close; after a
+// crash the trailing zeros are skipped when the file is reopened.
+// Not thread safe, the owner serialises access.
+class LogFile {
+public:
+    static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+    static constexpr unsigned DEFAULT_KEEP = 4;
+
+    LogFile();
+    ~LogFile();
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    // Appends to 'path' if it exists
+    Status open(const std::string& path, size_t maxBytes = DEFAULT_MAX_BYTES, unsigned keep = DEFAULT_KEEP);
+    bool isOpen() const { return fd_ != -1; }
+    void close();
+
+    void append(const char* data, size_t size);
+    void flush();
+    // Flushes if the oldest buffered byte has waited FLUSH_INTERVAL or longer
+    void flushIfDue();
+
+    const LogFileStats& getStats() const { return stats_; }
+
+private:
+    void rotate();
+    void prepareNext();
+    std::string rotatedPath(unsigned generation) const;
+
+    std::string path_;
+    size_t maxBytes_;
+    unsigned keep_;
+    int fd_;
+    int nextFd_;            // Preallocated file that becomes path_ on rotation, -1 if none
+    uint64_t written_;      // Bytes in the current file
+    std::vector<char> buffer_;
+    size_t buffered_;
+    uint64_t bufferedSince_; // CLOCK_MONOTONIC ns of the oldest buffered byte
+    LogFileStats stats_;
+};
+
+#endif // LOGFILE_H
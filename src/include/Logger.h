@@ -5,31 +5,73 @@
 #include <string>
 #include <iostream>
 #include <mutex>
+#include <atomic>
 #include <bitset>
 #include <sstream>
 #include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
 #include <time.h>
 #include <Config.h>
+#include "LogEvent.h"
+#include "LogFile.h"
+#include "Timestamp.h"
 
 
 
-// Convenience macros - now with enabled checks
-#define LOG_DEBUG(tag, msg)   \
-  if(Logger::getInstance().isEnabled(Logger::Level::DEBUG)) \
-    Logger::getInstance().log(Logger::Level::DEBUG, tag, msg)
-#define LOG_INFO(tag, msg) \
-    if(Logger::getInstance().isEnabled(Logger::Level::INFO)) \
-        Logger::getInstance().log(Logger::Level::INFO, tag, msg)
-#define LOG_WARNING(tag, msg) \
-    if(Logger::getInstance().isEnabled(Logger::Level::WARNING)) \
-        Logger::getInstance().log(Logger::Level::WARNING, tag, msg)
-#define LOG_ERROR(tag, msg) \
-    if(Logger::getInstance().isEnabled(Logger::Level::ERROR)) \
-        Logger::getInstance().log(Logger::Level::ERROR, tag, msg)
+// Lowest level compiled in: 0 DEBUG, 1 INFO, 2 WARNING, 3 ERROR. Release
+// builds pass -DLOG_MIN_LEVEL=1 so DEBUG lines, arguments included, are
+// not compiled at all.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// Each call site looks up its tag's runtime filter once, on first use
+#define LOG_AT(level, tag, msg) \
+    do { \
+        if (Logger::compiledIn<Logger::Level::level>) { \
+            static Logger::TagFilter& logTagFilter_ = Logger::getInstance().tagFilter(tag); \
+            if (Logger::getInstance().isEnabled(Logger::Level::level, logTagFilter_)) \
+                Logger::getInstance().log(Logger::Level::level, tag, msg); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(tag, msg)   LOG_AT(DEBUG, tag, msg)
+#define LOG_INFO(tag, msg)    LOG_AT(INFO, tag, msg)
+#define LOG_WARNING(tag, msg) LOG_AT(WARNING, tag, msg)
+#define LOG_ERROR(tag, msg)   LOG_AT(ERROR, tag, msg)
+
+// Deferred formatting: LOG_EVENT(INFO, PLANE_POSITION, id, x, y, z) records
+// the event id and raw arguments, the text is produced off the calling thread.
+// Filtered by the tag of the event's format.
+#define LOG_EVENT(level, id, ...) \
+    do { \
+        if (Logger::compiledIn<Logger::Level::level>) { \
+            static Logger::TagFilter& logTagFilter_ = \
+                Logger::getInstance().tagFilter(logEventFormat(LogEvent::id).tag); \
+            if (Logger::getInstance().isEnabled(Logger::Level::level, logTagFilter_)) \
+                Logger::getInstance().logEvent(Logger::Level::level, LogEvent::id, __VA_ARGS__); \
+        } \
+    } while (0)
 
 #define LOG_TO_FILE(tag, msg) \
   Logger::getInstance().logToFile(tag, msg)\
 
+struct LoggerStats {
+    uint64_t records = 0; // Lines accepted from callers
+    uint64_t dropped = 0; // Lines lost to a full buffer
+    uint64_t blocked = 0; // Times a caller waited for room
+    uint64_t writes = 0;  // write() calls made by the writer
+    uint64_t bytes = 0;
+};
+
+// Log lines are formatted by the calling thread into a ring buffer of its
+// own, with no lock, and a background writer thread drains every ring into
+// large write() calls on stdout. Lines from one thread keep their order;
+// lines from different threads are ordered by their timestamps only.
+// ERROR lines, flush() and shutdown() wait until everything logged before
+// them has been written.
 class Logger {
 public:
     enum class Level {
@@ -40,11 +82,35 @@ public:
         COUNT     // Used to size the bitset
     };
 
+    // What a caller does when its ring is full
+    enum class OverflowPolicy {
+        BLOCK, // Wait for the writer to make room
+        DROP,  // Discard the line, only counted in getStats()
+        COUNT  // Discard the line; the writer logs how many were lost in its place
+    };
+
+    // Runtime filter for one tag: the levels it logs, or INHERIT to follow
+    // the levels enabled for everything
+    struct TagFilter {
+        static constexpr uint32_t INHERIT = 0xFFFFFFFF;
+        static constexpr size_t NAME_BYTES = 32;
+
+        std::atomic<uint32_t> state;  // TAG_EMPTY, TAG_CLAIMED or TAG_READY
+        std::atomic<uint32_t> levels; // Bit per Level, or INHERIT
+        char name[NAME_BYTES];        // Longer tags are cut short
+
+        TagFilter() : state(0), levels(INHERIT), name() {}
+    };
+
     static Logger& getInstance() {
         static Logger instance;
         return instance;
     }
 
+    // Constant, so a call site below LOG_MIN_LEVEL is dropped even at -O0
+    template <Level level>
+    static constexpr bool compiledIn = static_cast<int>(level) >= LOG_MIN_LEVEL;
+
     // Enable specific log levels
     void enable(Level level) {
         enabledLevels.set(static_cast<size_t>(level), true);
@@ -60,6 +126,20 @@ public:
         return enabledLevels[static_cast<size_t>(level)];
     }
 
+    bool isEnabled(Level level, const TagFilter& filter) const {
+        uint32_t levels = filter.levels.load(std::memory_order_relaxed);
+        return levels == TagFilter::INHERIT ? isEnabled(level) : (levels >> static_cast<uint32_t>(level)) & 1;
+    }
+
+    // Logs 'minimum' and above for 'tag' whatever the levels enabled for
+    // everything; Level::COUNT silences the tag. Fails once the table is full.
+    Status setTagLevel(const std::string& tag, Level minimum);
+    // Back to the levels enabled for everything
+    void clearTagLevel(const std::string& tag);
+    // Finds or adds the filter for 'tag' without locking
+    TagFilter& tagFilter(const char* tag);
+    TagFilter& tagFilter(const std::string& tag) { return tagFilter(tag.c_str()); }
+
     // Enable all levels
     void enableAll() {
         enabledLevels.set();
@@ -70,63 +150,138 @@ public:
         enabledLevels.reset();
     }
 
-    void log(Level level, const std::string tag, const std::string& message) {
-        if (isEnabled(level)) {
-            std::lock_guard<std::mutex> lock(mutex);
-            std::string str = (level == Logger::Level::ERROR) ? "[ " + levelToString(level) + " ]": "";
-            std::cout << getTimestamp() << str << "[ " << tag << "] " << message << std::endl;
-        }
-    }
+    void setOverflowPolicy(OverflowPolicy policy) { overflowPolicy_.store(policy, std::memory_order_relaxed); }
+    OverflowPolicy getOverflowPolicy() const { return overflowPolicy_.load(std::memory_order_relaxed); }
+
+    // Writes unconditionally, the LOG_ macros do the filtering
+    void log(Level level, const std::string tag, const std::string& message);
 
-    std::string getTimestamp() {
-        time_t now = time(nullptr);
-        struct tm* timeinfo = localtime(&now);
+    template <typename... Args>
+    void logEvent(Level level, LogEvent event, const Args&... args) {
+        static_assert(sizeof...(Args) <= LOG_EVENT_MAX_ARGS, "Too many log event arguments");
+        char record[LOG_EVENT_MAX_BYTES];
+        char* end = logevent::encodeArgs(record + sizeof(LogEventHeader), args...);
+        *end++ = static_cast<char>(LOG_EVENT_END);
 
-        char buffer[9];  // HH:MM:SS\0
-        strftime(buffer, sizeof(buffer), "%H:%M:%S", timeinfo);
+        LogEventHeader header;
+        header.size = static_cast<uint16_t>(end - record);
+        header.event = static_cast<uint16_t>(event);
+        header.level = static_cast<uint8_t>(level);
+        header.argc = static_cast<uint8_t>(sizeof...(Args));
+        header.reserved = 0;
+        header.timeNs = Timestamp::wallNanos();
+        memcpy(record, &header, sizeof(header));
+        writeEvent(level, record, header.size);
+    }
 
-        std::stringstream ss;
-        ss << buffer;
+    // Sends LOG_EVENT records to a binary file, as they are, instead of
+    // formatting them for stdout; "atc --decode-log" prints the file
+    Status openBinaryLog(const std::string& path, size_t maxBytes = LogFile::DEFAULT_MAX_BYTES,
+                         unsigned keep = LogFile::DEFAULT_KEEP);
 
-        // Get milliseconds using a simpler approach
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        int ms = ts.tv_nsec / 1000000;  // Convert nanoseconds to milliseconds
+    // Returns once every line logged before the call has been written
+    void flush();
+    // Flushes and stops the writer; later lines are written synchronously
+    void shutdown();
 
-        // Format milliseconds with leading zeros
-        char ms_buffer[5];
-        snprintf(ms_buffer, sizeof(ms_buffer), ".%03d", ms);
-        ss << ms_buffer;
+    LoggerStats getStats() const;
 
-        return ss.str();
-    }
-    Status logToFile(const std::string tag, const std::string& message) {
-      std::lock_guard<std::mutex> lock(mutex);
-      std::ofstream file("log.txt", std::ios::app);
-      LOG_INFO("Logger", "Writing to log file");
-      if (!file.is_open()) {
-        LOG_ERROR("Logger", "Failed to open log file");
-        return Status::ERROR;
-      }
-
-      file << getTimestamp() << "[" << tag << "] " << message << std::endl;
-      file.flush();
-      file.close();
-      return Status::OK;
-    }
+    // HH:MM:SS.mmm, as at the start of every line
+    std::string getTimestamp() { return Timestamp::now(); }
+    // Appends a line to the log file, opening the default one on first use.
+    // Buffered; written out by the writer thread at least once a second.
+    Status logToFile(const std::string tag, const std::string& message);
+    // Replaces the log file; rotates at 'maxBytes', keeping 'keep' old files
+    Status openLogFile(const std::string& path, size_t maxBytes = LogFile::DEFAULT_MAX_BYTES,
+                       unsigned keep = LogFile::DEFAULT_KEEP);
+    LogFileStats getLogFileStats();
 
 private:
-    Logger() {
-        // By default, enable all except DEBUG
-        enableAll();
-        disable(Level::DEBUG);
-    }
+    // Single producer (the owning thread), single consumer (the writer).
+    // Holds records, each a frame header and a text line or LOG_EVENT record,
+    // 8-byte aligned and never wrapping. Positions only grow; a record is
+    // visible to the writer once 'head' has moved past it.
+    struct Ring {
+        static constexpr size_t BYTES = 64 * 1024;
+
+        // Head and tail on their own cache lines so owner and writer do not contend
+        std::atomic<uint64_t> head; // Written by the owner
+        char headPadding[64 - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> tail; // Written by the writer
+        char tailPadding[64 - sizeof(std::atomic<uint64_t>)];
+        std::atomic<bool> owned;    // Claimed by a live thread
+        std::atomic<uint64_t> lost; // Lines dropped since the writer last looked
+        std::atomic<uint64_t> records;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> blocked;
+        char data[BYTES];
+
+        Ring() : head(0), tail(0), owned(true), lost(0), records(0), dropped(0), blocked(0) {}
+    };
+
+    // Releases the calling thread's ring when it exits, for the next thread to reuse
+    struct RingHandle {
+        Ring* ring = nullptr;
+        ~RingHandle();
+    };
+
+    struct Piece {
+        const char* data;
+        size_t size;
+    };
+
+    static constexpr size_t RING_SLOTS = 64;
+    static constexpr size_t TAG_SLOTS = 128;
+
+    Logger();
+    ~Logger();
 
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    static void* writerThreadFunc(void* arg);
+    void writerLoop();
+
+    Ring* threadRing();
+    // Room for one record of 'bytes' in the ring, or nullptr if the line is
+    // dropped or the writer stopped; commit() publishes it
+    char* reserve(Ring& ring, uint32_t kind, size_t bytes, uint64_t& end);
+    void commit(Ring& ring, uint64_t end);
+    void writeEvent(Level level, const char* record, size_t size);
+    void writeDirect(const Piece* pieces, size_t count);
+    void drainAll();
+    void writeBatch();
+    void wakeWriter();
+    void flushFile(bool force);
+
     std::bitset<static_cast<size_t>(Level::COUNT)> enabledLevels;
-    std::mutex mutex;
+    std::mutex fileMutex;      // Guards file_ and binaryFile_
+    LogFile file_;
+    LogFile binaryFile_;
+    std::atomic<bool> binaryEnabled_;
+    std::atomic<OverflowPolicy> overflowPolicy_;
+
+    // Open addressing on the tag's hash; entries are added, never removed
+    TagFilter tags_[TAG_SLOTS];
+    TagFilter untracked_;      // Shared by tags that found the table full, always INHERIT
+
+    std::atomic<Ring*> rings_[RING_SLOTS];
+    std::atomic<bool> writerRunning_;
+
+    // Writer state
+    pthread_t writer_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t wake_;      // Flush requested, room needed or stopping
+    pthread_cond_t flushed_;
+    uint64_t flushRequests_;
+    uint64_t flushesDone_;
+    bool stopping_;
+    std::string batch_;
+    std::string binaryBatch_;
+    std::mutex outputMutex_;   // One write() at a time, keeps lines whole
+    std::atomic<uint64_t> writes_;
+    std::atomic<uint64_t> bytes_;
+    std::atomic<uint64_t> sharedRecords_; // Lines written synchronously
 
 
 //    const char* levelToString(Level level) {
@@ -0,0 +1,70 @@
+// LookaheadTiers.h
+#ifndef LOOKAHEADTIERS_H
+#define LOOKAHEADTIERS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "BroadPhase.h"
+#include "ConflictDetector.h"
+#include "messages.h"
+
+// One lookahead horizon of the separation checker
+struct LookaheadTier {
+    std::string name;
+    double horizon;        // Seconds
+    uint32_t cadence;      // Checked every 'cadence' radar frames
+    BroadPhase broadPhase; // Unused by the first tier, which the checker runs itself
+};
+
+struct TierStats {
+    std::string name;
+    double horizon = 0.0;
+    uint32_t cadence = 1;
+    uint64_t checks = 0;
+    size_t conflicts = 0;   // Last check, only those beyond the next shorter horizon
+    double lastMs = 0.0;
+    double meanMs = 0.0;    // Per check
+    double perFrameMs = 0.0; // Mean spread over the frames between checks
+};
+
+// Short-term alert, medium-term advisory and long-term strategic horizons
+// share one engine. The first tier is the alert tier: the checker runs it on
+// every frame and corrects what it finds. Longer tiers only report; each runs
+// every 'cadence' frames with its own broad phase, by default one that cuts
+// the horizon into short slices, so a ten-minute horizon costs a fraction of
+// a frame on average. They are meant for a thread other than the checker's,
+// which keeps its own alert tier statistics.
+class LookaheadTiers {
+public:
+    LookaheadTiers();
+
+    static std::vector<LookaheadTier> defaults(double alertHorizon);
+    // Sorted by horizon with the first tier's cadence forced to 1
+    static std::vector<LookaheadTier> normalize(std::vector<LookaheadTier> tiers);
+    static TierStats emptyStats(const LookaheadTier& tier);
+    // Adds one check of 'conflicts' that took 'ms' to 'stats'
+    static void record(TierStats& stats, size_t conflicts, double ms);
+
+    // Normalized first; the first tier always runs every frame
+    void configure(std::vector<LookaheadTier> tiers);
+    const std::vector<LookaheadTier>& tiers() const { return tiers_; }
+    double alertHorizon() const { return tiers_.front().horizon; }
+
+    void setWorkerCount(size_t workers) { detector_.setWorkerCount(workers); }
+
+    // Runs every longer tier that fell due after radar frame 'lastFrame', up
+    // to and including 'frame', once; a busy caller may skip frames
+    void checkLongerTiers(uint64_t lastFrame, uint64_t frame, const std::vector<PlaneState>& states);
+
+    const std::vector<TierStats>& getStats() const { return stats_; }
+
+private:
+    std::vector<LookaheadTier> tiers_;
+    std::vector<TierStats> stats_;
+    ConflictDetector detector_;       // Shared by the longer tiers, they run one after another
+    std::vector<Conflict> conflicts_;
+};
+
+#endif // LOOKAHEADTIERS_H
@@ -0,0 +1,57 @@
+// PlaneStateTable.h
+#ifndef PLANESTATETABLE_H
+#define PLANESTATETABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "vector.h"
+
+// One aircraft in the shared table. 'sequence' is a seqlock counter: odd
+// while the owning plane is writing, even once the slot is consistent.
+struct PlaneStateSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t active;
+    char id[16];
+    double position[3];
+    double velocity[3];
+    char padding[128 - 2 * sizeof(uint32_t) - 16 - 6 * sizeof(double)];
+};
+
+// Position/velocity table in shared memory. Each plane publishes into its
+// own slot; readers (the radar) copy every slot in one pass without IPC and
+// retry a slot only if a write overlapped the copy.
+class PlaneStateTable {
+public:
+    explicit PlaneStateTable(size_t capacity = 4096);
+    ~PlaneStateTable();
+
+    bool isValid() const { return slots_ != nullptr; }
+
+    // Returns a free slot, -1 if the table is full
+    int acquire(const std::string& id);
+    void release(int slot);
+
+    // Single writer per slot
+    void publish(int slot, const Vector& position, const Vector& velocity);
+    // Returns false if the slot is not in use
+    bool read(int slot, char id[16], Vector& position, Vector& velocity) const;
+
+private:
+    PlaneStateTable(const PlaneStateTable&) = delete;
+    PlaneStateTable& operator=(const PlaneStateTable&) = delete;
+
+    size_t capacity_;
+    size_t bytes_;
+    std::string name_;
+    int fd_;
+    PlaneStateSlot* slots_;
+
+    std::mutex mtx;             // Guards freeSlots_
+    std::vector<int> freeSlots_;
+};
+
+#endif // PLANESTATETABLE_H
@@ -0,0 +1,125 @@
+// RadarFrame.h
+#ifndef RADARFRAME_H
+#define RADARFRAME_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "AircraftIdTable.h"
+#include "Config.h"
+#include "messages.h"
+
+// Radar -> ComputerSystem frame. Keyframes carry every tracked aircraft.
+// Delta frames carry only aircraft that were added, changed velocity, or
+// drifted from the straight-line prediction, plus removed tracks. The
+// receiver integrates everything else forward by 'dt'.
+//
+// Wire layout: RadarFrameHeader, addedCount TrackAdded,
+// changedCount TrackChanged, removedCount uint32_t track numbers.
+// Track numbers are the aircraft handles from AircraftIdTable.
+enum class RadarFrameType : uint32_t {
+    KEYFRAME = 0,
+    DELTA = 1
+};
+
+struct RadarFrameHeader {
+    RadarFrameType type;
+    uint32_t frame;
+    double dt;              // Seconds since the previous frame
+    uint32_t addedCount;
+    uint32_t changedCount;
+    uint32_t removedCount;
+    uint32_t reserved;
+};
+
+struct TrackAdded {
+    uint32_t track;
+    PlaneState state;
+};
+
+struct TrackChanged {
+    uint32_t track;
+    Vector position;
+    Vector velocity;
+};
+
+// Bytes sent against the bytes the same frames would take as full lists
+struct RadarFrameStats {
+    uint64_t frames;
+    uint64_t keyframes;
+    uint64_t bytesSent;
+    uint64_t fullFrameBytes;
+
+    double ratio() const { return bytesSent ? double(fullFrameBytes) / double(bytesSent) : 0.0; }
+};
+
+// Radar side: mirrors what the receiver believes about every track
+class RadarFrameEncoder {
+public:
+    RadarFrameEncoder(uint32_t keyframeInterval = 30, double positionTolerance = 100.0);
+
+    // Starts a frame 'dt' seconds after the previous one
+    void begin(double dt);
+    // Aircraft measured in this sweep
+    void track(uint32_t track, const PlaneState& state);
+    // Aircraft that left; only reported if the receiver knows about it
+    void remove(uint32_t track);
+    Status send(int coid);
+
+    uint32_t getTrackedCount() const { return static_cast<uint32_t>(tracks_.size()); }
+    const RadarFrameStats& getStats() const { return stats_; }
+
+private:
+    struct Prediction {
+        Vector position;
+        Vector velocity;
+    };
+
+    uint32_t keyframeInterval_;
+    double positionTolerance_;
+    uint32_t frame_;
+    bool keyframe_;
+    bool forceKeyframe_;
+    double dt_;
+    size_t measured_;
+    std::unordered_map<uint32_t, Prediction> tracks_;
+
+    std::vector<TrackAdded> added_;
+    std::vector<TrackChanged> changed_;
+    std::vector<uint32_t> removed_;
+    RadarFrameStats stats_;
+};
+
+// ComputerSystem side: rebuilds the aircraft list from the frames
+class RadarFrameDecoder {
+public:
+    // 'header' is what MsgReceive returned; the rest is pulled with MsgRead
+    // and applied to 'states'
+    Status apply(int rcvid, const RadarFrameHeader& header, std::vector<PlaneState>& states);
+
+    // Position of an aircraft in 'states', HandleIndex::NONE if not tracked
+    uint32_t indexOf(uint32_t handle) const { return index_.find(handle); }
+    const HandleIndex& getIndex() const { return index_; }
+
+    // Tracks the last applied frame dropped, explicitly or by omission from a keyframe
+    const std::vector<uint32_t>& getDropped() const { return dropped_; }
+    // Tracks the last applied frame added or corrected; every track for a keyframe
+    const std::vector<uint32_t>& getTouched() const { return touched_; }
+    // tracks[i] is the track of states[i]
+    const std::vector<uint32_t>& getTracks() const { return tracks_; }
+
+private:
+    void addTrack(uint32_t track, const PlaneState& state, std::vector<PlaneState>& states);
+    void removeTrack(uint32_t track, std::vector<PlaneState>& states);
+
+    std::vector<uint32_t> tracks_;                    // tracks_[i] is the track of states[i]
+    HandleIndex index_;                               // track -> position in states
+
+    std::vector<TrackAdded> added_;
+    std::vector<TrackChanged> changed_;
+    std::vector<uint32_t> removed_;
+    std::vector<uint32_t> dropped_;
+    std::vector<uint32_t> touched_;
+};
+
+#endif // RADARFRAME_H
@@ -0,0 +1,26 @@
+// SeparationKernel.h
+#ifndef SEPARATIONKERNEL_H
+#define SEPARATIONKERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "AircraftSoA.h"
+
+// Instruction set used by the separation kernel
+enum class KernelIsa {
+    SCALAR = 0,
+    AVX2 = 1     // 4 aircraft per instruction
+};
+
+// Best kernel supported by the CPU we are running on
+KernelIsa detectKernelIsa();
+const char* kernelIsaName(KernelIsa isa);
+
+// Tests aircraft 'a' against entries [begin, end) of the SoA over the
+// lookahead window. Writes the SoA positions of every entry that loses
+// separation with 'a' to 'hits' (room for end - begin) and returns the count.
+// Every ISA reports exactly the same hits as computeClosestApproach.
+size_t separationKernel(KernelIsa isa, const AircraftSoA& soa, uint32_t a,
+                        uint32_t begin, uint32_t end, double lookahead, uint32_t* hits);
+
+#endif // SEPARATIONKERNEL_H
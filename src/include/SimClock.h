@@ -0,0 +1,100 @@
+// SimClock.h
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <pthread.h>
+#include <time.h>
+
+// Central fixed-timestep simulation clock. Every tick runs the attached
+// participants phase by phase (all SIMULATION participants, then SENSORS) and
+// only moves on once each of them has called complete(), so a run is
+// reproducible regardless of scheduling.
+//
+// Conflict checking needs no phase of its own. The computer system holds the
+// radar's reply until the frame is checked, so the check is part of SENSORS.
+// Pacing between ticks is real time, N times real time, or none at all.
+class SimClock {
+public:
+    enum class Mode {
+        REALTIME,
+        ACCELERATED,
+        AS_FAST_AS_POSSIBLE
+    };
+
+    enum Phase : uint32_t {
+        SIMULATION = 0, // Aircraft motion
+        SENSORS,        // Radar sweep, including the check of the frame it sends
+        PHASE_COUNT
+    };
+
+    static SimClock& getInstance() {
+        static SimClock instance;
+        return instance;
+    }
+
+    // Must be called before start(); 'speedup' is only used in ACCELERATED mode
+    void configure(Mode mode, double speedup = 1.0, double timestep = 1.0);
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Registers a participant; returns its id
+    int attach(Phase phase);
+    // Wakes the participant if it is waiting, it is no longer waited for
+    void detach(int participant);
+
+    // Blocks until the participant's phase of the next tick, also before the
+    // clock starts; returns false once the clock stopped or the participant was detached
+    bool awaitTick(int participant, uint64_t& tick);
+    void complete(int participant);
+
+    // Blocks until every tick up to simulated time 'seconds' has completed;
+    // returns false if the clock stopped first
+    bool waitUntil(double seconds);
+
+    uint64_t getTick() const { return tick_; }
+    double now() const { return tick_ * timestep_; }
+    double getTimestep() const { return timestep_; }
+    Mode getMode() const { return mode_; }
+    double getSpeedup() const { return speedup_; }
+
+private:
+    struct Participant {
+        Phase phase;
+        bool attached;
+        uint64_t doneTick; // Last tick this participant completed
+    };
+
+    SimClock();
+    ~SimClock();
+    SimClock(const SimClock&) = delete;
+    SimClock& operator=(const SimClock&) = delete;
+
+    static void* threadFunc(void* arg);
+    void run();
+    void runPhase(Phase phase);  // Caller holds mutex_
+    void pace(const struct timespec& start, uint64_t tick);
+
+    Mode mode_;
+    double speedup_;
+    double timestep_;
+
+    pthread_t thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> tick_;
+
+    pthread_mutex_t mutex_;
+    pthread_cond_t phaseCond_; // Signalled when a phase starts or the clock stops
+    pthread_cond_t doneCond_;  // Signalled when a participant completes or detaches
+    bool stopped_;             // Set by stop(), releases all waiters
+    uint64_t completedTick_;   // Last tick all phases finished
+    std::vector<Participant> participants_;
+    uint32_t phase_;           // Running phase, PHASE_COUNT between ticks
+    size_t pending_;           // Participants of phase_ that have not completed
+};
+
+#endif // SIMCLOCK_H
@@ -0,0 +1,115 @@
+// SimulationEngine.h
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include "AircraftIdTable.h"
+#include "AlignedAllocator.h"
+#include "vector.h"
+
+class PlaneStateTable;
+
+// Owns every simulated aircraft in contiguous columns and advances them all
+// with one integrator step per SimClock tick, instead of one thread per plane.
+// Velocity and position changes are queued and applied at the start of the
+// next tick. Two shared channels replace the per-plane ones: radar queries
+// (RadarQueryMsg with aircraft_id = handle) and course corrections.
+class SimulationEngine {
+public:
+    static SimulationEngine& getInstance() {
+        static SimulationEngine instance;
+        return instance;
+    }
+
+    // Starts the integrator and message threads; idempotent
+    void start();
+    void stop();
+
+    // Returns false if the aircraft is already simulated
+    bool add(uint32_t handle, const Vector& position, const Vector& velocity);
+    void remove(uint32_t handle);
+    bool contains(uint32_t handle) const;
+
+    // Returns false if the aircraft is not simulated
+    bool getState(uint32_t handle, Vector& position, Vector& velocity) const;
+
+    // Queued, applied at the next tick
+    void setVelocity(uint32_t handle, const Vector& velocity);
+    void setPosition(uint32_t handle, const Vector& position);
+
+    // Advances a single aircraft by 'dt' right away, returns its new position
+    Vector advance(uint32_t handle, double dt);
+
+    void setStateSlot(uint32_t handle, PlaneStateTable* table, int slot);
+
+    // Hash of the complete simulated state, equal across bit-identical runs
+    uint64_t stateDigest() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return digest();
+    }
+
+    int getQueryChannelId() const { return query_chid_; }
+    int getCorrectionChannelId() const { return correction_chid_; }
+    size_t size() const;
+
+private:
+    enum class CommandType {
+        SET_VELOCITY,
+        SET_POSITION
+    };
+
+    struct Command {
+        CommandType type;
+        uint32_t handle;
+        Vector value;
+    };
+
+    typedef std::vector<double, AlignedAllocator<double>> Column;
+
+    SimulationEngine();
+    ~SimulationEngine();
+    SimulationEngine(const SimulationEngine&) = delete;
+    SimulationEngine& operator=(const SimulationEngine&) = delete;
+
+    static void* tickThreadFunc(void* arg);
+    static void* queryThreadFunc(void* arg);
+    static void* correctionThreadFunc(void* arg);
+    void tickLoop();
+    void queryLoop();
+    void correctionLoop();
+
+    void tick(double dt);
+    void applyCommands();        // Caller holds mtx
+    void integrate(double dt);   // Caller holds mtx
+    void publish(uint32_t slot); // Caller holds mtx
+    uint64_t digest() const;     // Caller holds mtx
+    void logPositions() const;   // Caller holds mtx
+    void enqueue(const Command& command);
+
+    std::atomic<bool> running_;
+    pthread_t tick_thread_;
+    pthread_t query_thread_;
+    pthread_t correction_thread_;
+    int query_chid_;
+    int correction_chid_;
+    int clockId_;        // SimClock participant, SIMULATION phase
+
+    // Aircraft state, one entry per simulated aircraft
+    mutable std::mutex mtx;
+    Column x_, y_, z_;
+    Column vx_, vy_, vz_;
+    std::vector<uint32_t> handles_;
+    std::vector<PlaneStateTable*> stateTables_;
+    std::vector<int> stateSlots_;
+    HandleIndex index_;
+
+    std::mutex commandMtx;
+    std::vector<Command> commands_;
+    std::vector<Command> pending_; // Drained copy, only used by the tick thread
+};
+
+#endif // SIMULATIONENGINE_H
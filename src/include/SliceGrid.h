@@ -0,0 +1,104 @@
+// SliceGrid.h
+#ifndef SLICEGRID_H
+#define SLICEGRID_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "messages.h"
+
+// Dense 3D grid over where every aircraft will be at one instant, rebuilt for
+// each slice of a TIME_SLICED check. Cells are at least the requested size
+// and are bucketed with a counting sort over the bounding box, so a build is
+// linear with no hashing. Cells grow when the box would need more than a few
+// per aircraft, as it does once long extrapolations spread the traffic out.
+// Positions and velocities are stored in cell order so pair scans stream
+// through memory; entries are addressed by their position in that order.
+class SliceGrid {
+public:
+    SliceGrid();
+
+    // Positions 'time' seconds from now; two aircraft closer than cellXY
+    // horizontally on each axis and cellZ vertically share or neighbour a cell
+    void build(const std::vector<PlaneState>& states, double time, double cellXY, double cellZ);
+
+    // Entry e: projected position, velocity and snapshot index
+    double x(uint32_t e) const { return x_[e]; }
+    double y(uint32_t e) const { return y_[e]; }
+    double z(uint32_t e) const { return z_[e]; }
+    double vx(uint32_t e) const { return vx_[e]; }
+    double vy(uint32_t e) const { return vy_[e]; }
+    double vz(uint32_t e) const { return vz_[e]; }
+    uint32_t index(uint32_t e) const { return order_[e]; }
+
+    // Calls visit(a, begin, end) so that pairing entry a with each entry of
+    // [begin, end) over all calls covers every pair of aircraft in the same or
+    // neighbouring cells exactly once. A column of cells along Z is contiguous,
+    // so each entry needs at most five runs.
+    template <typename Visit>
+    void forEachSpan(Visit visit) const;
+
+    // Number of pairs forEachSpan would visit, without visiting them
+    uint64_t countPairs() const;
+
+private:
+    std::vector<double> x_, y_, z_;   // In cell order
+    std::vector<double> vx_, vy_, vz_;
+    size_t nx_, ny_, nz_;
+    std::vector<double> px_, py_, pz_; // Projected positions in snapshot order, while building
+    std::vector<uint32_t> cellOf_;    // Cell of each aircraft
+    std::vector<uint32_t> cellStart_; // Range of each cell in order_, plus an end marker
+    std::vector<uint32_t> order_;     // Snapshot indices grouped by cell
+    std::vector<uint32_t> fill_;      // Next free slot of each cell while building
+};
+
+template <typename Visit>
+void SliceGrid::forEachSpan(Visit visit) const {
+    // Columns after this one in linear order: (0, 1), (1, -1), (1, 0), (1, 1)
+    static const int FORWARD[4][2] = { { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } };
+
+    for (size_t cx = 0; cx < nx_; ++cx) {
+        for (size_t cy = 0; cy < ny_; ++cy) {
+            for (size_t cz = 0; cz < nz_; ++cz) {
+                size_t cell = (cx * ny_ + cy) * nz_ + cz;
+                uint32_t begin = cellStart_[cell];
+                uint32_t end = cellStart_[cell + 1];
+                if (begin == end) {
+                    continue;
+                }
+                // The rest of this cell and the cell above it
+                uint32_t above = cellStart_[cz + 1 < nz_ ? cell + 2 : cell + 1];
+                size_t low = cz > 0 ? cz - 1 : 0;
+                size_t high = std::min(cz + 1, nz_ - 1);
+
+                uint32_t runBegin[4], runEnd[4];
+                size_t runs = 0;
+                for (const auto& d : FORWARD) {
+                    size_t ox = cx + d[0], oy = cy + d[1];
+                    // Out of range offsets wrap to huge values
+                    if (ox >= nx_ || oy >= ny_) {
+                        continue;
+                    }
+                    size_t column = (ox * ny_ + oy) * nz_;
+                    runBegin[runs] = cellStart_[column + low];
+                    runEnd[runs] = cellStart_[column + high + 1];
+                    if (runBegin[runs] != runEnd[runs]) {
+                        ++runs;
+                    }
+                }
+
+                for (uint32_t a = begin; a < end; ++a) {
+                    if (a + 1 < above) {
+                        visit(a, a + 1, above);
+                    }
+                    for (size_t r = 0; r < runs; ++r) {
+                        visit(a, runBegin[r], runEnd[r]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif // SLICEGRID_H
@@ -0,0 +1,51 @@
+// SpatialGrid.h
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "BroadPhase.h"
+#include "messages.h"
+
+// Uniform 3D hash grid over the current aircraft positions.
+// Cells are sized so that two aircraft which can lose separation at any time
+// inside the lookahead window always sit in the same or in adjacent cells:
+// separation minimum plus the largest closing distance over the window.
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    void build(const std::vector<PlaneState>& states, double lookahead);
+
+    // Snapshot indices grouped by cell; spans refer to positions in this list
+    const std::vector<uint32_t>& order() const { return order_; }
+
+    // Appends spans covering every pair of aircraft sharing a cell or in
+    // neighbouring cells, each pair exactly once
+    void candidateSpans(std::vector<CandidateSpan>& out) const;
+
+    double getCellSizeXY() const { return cellSizeXY_; }
+    double getCellSizeZ() const { return cellSizeZ_; }
+    size_t getCellCount() const { return cells_.size(); }
+
+private:
+    struct CellRange {
+        uint32_t begin; // Range in order_
+        uint32_t end;
+    };
+
+    uint64_t cellKey(int64_t cx, int64_t cy, int64_t cz) const;
+    int64_t cellCoord(double value, double cellSize) const;
+
+    double cellSizeXY_;
+    double cellSizeZ_;
+    std::vector<uint32_t> order_;   // Aircraft indices grouped by cell
+    std::vector<uint64_t> keys_;    // Cell key of each entry of order_
+    std::unordered_map<uint64_t, CellRange> cells_;
+    std::vector<int64_t> coords_;   // Cell coordinates (x, y, z) per cell, same order as cellList_
+    std::vector<CellRange> cellList_;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,45 @@
+// SweepAndPrune.h
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "BroadPhase.h"
+#include "messages.h"
+
+// Sweep-and-prune along the X axis. Each aircraft covers the X interval it
+// can reach within the lookahead, widened by half the horizontal minimum, so
+// two aircraft can only lose separation if their intervals overlap.
+// The sorted order is kept between builds and repaired with an insertion
+// sort, which stays close to linear while aircraft barely change places from
+// one frame to the next.
+class SweepAndPrune {
+public:
+    SweepAndPrune();
+
+    void build(const std::vector<PlaneState>& states, double lookahead);
+
+    // Snapshot indices sorted by interval start; spans refer to positions in this list
+    const std::vector<uint32_t>& order() const { return order_; }
+
+    // Appends one span per aircraft covering every later aircraft whose
+    // interval overlaps its own, so each pair appears exactly once
+    void candidateSpans(std::vector<CandidateSpan>& out) const;
+
+    size_t getLastShifts() const { return shifts_; } // Insertion sort moves in the last build
+    uint64_t getFullSorts() const { return fullSorts_; }
+
+private:
+    void sortFromScratch();
+
+    std::vector<uint32_t> order_;  // Persistent between builds
+    std::vector<double> lower_;    // Interval per snapshot index
+    std::vector<double> upper_;
+    std::vector<double> begin_;    // Interval per entry of order_
+    std::vector<double> end_;
+    size_t shifts_;
+    uint64_t fullSorts_;
+};
+
+#endif // SWEEPANDPRUNE_H
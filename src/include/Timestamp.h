@@ -0,0 +1,35 @@
+// Timestamp.h
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <time.h>
+
+// Clock readings for log lines and latency measurements. Wall-clock time is
+// CLOCK_MONOTONIC plus the offset to CLOCK_REALTIME taken at first use, so
+// log timestamps never step backwards when the system clock is set.
+// Formatting keeps the HH:MM:SS text of the last second seen by each thread
+// and only fills in the milliseconds, without allocating.
+class Timestamp {
+public:
+    static constexpr size_t TEXT_LENGTH = 12; // HH:MM:SS.mmm
+
+    static uint64_t monotonicNanos() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+    }
+
+    // Nanoseconds since the epoch
+    static uint64_t wallNanos();
+
+    // Writes the local time of 'wallNs' as HH:MM:SS.mmm to 'out', which must
+    // hold TEXT_LENGTH characters; no terminator. Returns TEXT_LENGTH.
+    static size_t format(uint64_t wallNs, char* out);
+    static size_t now(char* out) { return format(wallNanos(), out); }
+    static std::string now();
+};
+
+#endif // TIMESTAMP_H
@@ -0,0 +1,68 @@
+// WorkerPool.h
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <pthread.h>
+
+// Fixed pool of worker threads running data-parallel loops. Each worker
+// starts on its own contiguous slice of the index space and, once that is
+// drained, steals the back half of another worker's remaining slice.
+class WorkerPool {
+public:
+    // Task receives [begin, end) and the index of the worker running it
+    typedef std::function<void(size_t begin, size_t end, size_t worker)> Task;
+
+    // 'workers' includes the calling thread, so workers - 1 threads are started
+    explicit WorkerPool(size_t workers);
+    ~WorkerPool();
+
+    size_t size() const { return workerCount_; }
+
+    // Runs task over [0, count) in chunks of at most 'grain' and returns once
+    // everything has been processed. The caller takes part as worker 0.
+    void parallelFor(size_t count, size_t grain, const Task& task);
+
+private:
+    // Remaining slice of one worker, begin in the high half, end in the low half.
+    // Padded to a cache line so workers do not false-share.
+    struct Slice {
+        std::atomic<uint64_t> bounds;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    static void* threadFunc(void* arg);
+    void workerLoop(size_t worker);
+    void work(size_t worker);
+    bool takeOwn(size_t worker, uint32_t& begin, uint32_t& end);
+    bool steal(size_t thief);
+
+    static uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t(begin) << 32) | end; }
+
+    struct ThreadArg {
+        WorkerPool* pool;
+        size_t worker;
+    };
+
+    size_t workerCount_;
+    std::vector<pthread_t> threads_;
+    std::vector<ThreadArg> args_;
+    std::unique_ptr<Slice[]> slices_;
+
+    pthread_mutex_t mutex_;
+    pthread_cond_t startCond_;
+    pthread_cond_t doneCond_;
+    uint64_t generation_;   // Bumped for every parallelFor
+    size_t busyWorkers_;
+    bool running_;
+
+    const Task* task_;
+    uint32_t grain_;
+};
+
+#endif // WORKERPOOL_H
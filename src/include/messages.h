@@ -2,13 +2,18 @@
 #ifndef MESSAGES_H
 #define MESSAGES_H
 
+#include <string>
+#include <cstdint>
 #include "vector.h"
 
 enum class ConsoleCommand {
     LIST_PLANES = 0,
     DISPLAY_PLANE_DATA = 1,
     UPDATE_PLANE_VELOCITY = 2,
-    UPDATE_PLANE_POSITION = 3
+    UPDATE_PLANE_POSITION = 3,
+    FIND_WITHIN_RADIUS = 4,
+    FIND_IN_BOX = 5,
+    FIND_NEAREST = 6
 };
 
 
@@ -19,15 +24,44 @@ struct PlaneState {
     Vector velocity;
     int coid_comp;
 };
-// For sending multiple planes to console
-struct PlaneListMsg {
-    int numPlanes;
-    PlaneState planes[50];  // Maximum 50 planes
+// Header of a variable-length aircraft list. It is followed on the wire
+// by 'count' PlaneState records, which are entries [offset, offset + count)
+// of a snapshot holding 'total' aircraft.
+struct AircraftListHeader {
+    uint32_t frame;  // Snapshot the records belong to
+    uint32_t total;
+    uint32_t offset;
+    uint32_t count;
 };
 
-struct courseCorrectionMsg {
-	std::string id;
-	Vector newVelocity;
+// Asks for the chunk of the current snapshot starting at 'offset'
+struct AircraftListRequest {
+    uint32_t offset;
+    uint32_t maxRecords; // Room in the reply buffer
+};
+
+// Spatial query against the current snapshot. The reply is an aircraft list,
+// closest first for FIND_NEAREST.
+struct SpatialQuery {
+    Vector point;   // Centre for radius and nearest, low corner for box
+    Vector high;    // High corner for box
+    double radius;
+    uint32_t count; // Aircraft asked for by FIND_NEAREST
+    uint32_t reserved;
+};
+
+// Header of a course correction batch. It is followed on the wire by
+// 'count' CourseCorrectionMsg records, all for the same channel.
+struct CourseCorrectionHeader {
+    uint32_t count;
+    uint32_t reserved;
+};
+
+// New velocity for one aircraft, identified by its AircraftIdTable handle
+struct CourseCorrectionMsg {
+    uint32_t handle;
+    uint32_t reserved;
+    Vector newVelocity;
 };
 
 // Message from Radar to Plane
@@ -47,19 +81,6 @@ struct PlaneResponseMsg {
 
 
 
-// Message from Radar to ComputerSystem
-struct RadarToComputerMsg {
-    int numAircraft;
-    PlaneState aircraftData[100]; // Adjust size as needed
-    int coid_comp;
-};
-
-// Message from ComputerSystem to DataDisplay
-struct ComputerToDataDisplayMsg {
-    int numAircraft;
-    PlaneState aircraftData[50]; // Maximum of 50 aircraft
-};
-
 // Operator commands
 struct OperatorCommandMsg {
 	ConsoleCommand type;
@@ -67,10 +88,15 @@ struct OperatorCommandMsg {
     char planeId[16];
     Vector velocity;
     Vector position;
+    // For LIST_PLANES and the spatial queries
+    AircraftListRequest list;
+    // For FIND_WITHIN_RADIUS, FIND_IN_BOX and FIND_NEAREST
+    SpatialQuery query;
 };
 
 struct DataDisplayRequestMsg {
     bool requestAugmentedData;
+    AircraftListRequest list;
     // Additional fields if needed
 };
 #endif // MESSAGES_H
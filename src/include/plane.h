@@ -3,11 +3,13 @@
 #define PLANE_H
 
 #include <string>
-#include <mutex>
-#include <pthread.h>
-#include <sys/neutrino.h>
+#include <cstdint>
 #include "vector.h"
 
+class PlaneStateTable;
+
+// Handle to one aircraft simulated by the SimulationEngine. The plane owns no
+// threads or channels; state lives in the engine and changes are queued there.
 class Plane {
 public:
     Plane();
@@ -19,45 +21,37 @@ public:
 
     Vector get_pos() const;
     Vector get_speed() const;
-    std::string get_id() const;
+    const std::string& get_id() const;
+    uint32_t get_handle() const;
 
     void set_velocity(Vector speed);
     void set_pos(Vector position);
 
+    // Moves the plane by one clock timestep right away; once started this
+    // advances its slot in the engine, on top of the engine's own ticks
     Vector update_position();
 
+    // Shared engine channels; queries carry the aircraft handle
     int getChannelId() const;
     int getChannelIdComp() const;
 
-private:
-    static void* threadFunc(void* arg);
-    static void* msgThreadFunc(void* arg);
-    static void* courseCorrectThreadFunc(void* arg);
-    void messageLoop();
-    void courseCorrectLoop();
+    // Publish position and velocity into a shared state table slot on every change
+    void setStateSlot(PlaneStateTable* table, int slot);
 
 private:
 
     std::string id;
+    uint32_t handle_;
+
+    // Initial state, handed to the engine on start()
     Vector position;
     Vector velocity;
 
-    pthread_t thread_;       // Position update thread
-    pthread_t msg_thread_;   // Message handling thread
-    pthread_t course_currect_thread_; //course correction
     bool running_;
-    mutable std::mutex mtx;
 
-    // IPC variables
-    int chid_; // Channel ID for receiving messages
-    int chid_comp_;
-
-    // Time step for position updates
+    // Time step for position updates, the simulation clock's timestep
     double dt;
 
-    // Synchronization for IPC
-    pthread_mutex_t mutex_;
-
 };
 
 #endif // PLANE_H
@@ -5,14 +5,26 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <time.h>
 #include <pthread.h>
 #include "plane.h"
 #include "messages.h"
+#include "PlaneStateTable.h"
+#include "RadarFrame.h"
 
 struct PlaneConnection {
    Plane* plane;
    int coid; // Connection ID to the Plane's channel
    int coid_comp; //connection ID for computer to plane's computer channel
+   int slot; // Slot in the shared state table, -1 if the plane is only reachable by message
+   uint32_t handle; // Interned id, also the track number in radar frames
+};
+
+// How the radar samples aircraft each sweep
+enum class RadarQueryMode {
+    SHARED_MEMORY,   // Read the seqlock state table, no IPC
+    MESSAGE_PASSING  // One MsgSend per plane
 };
 
 struct Bounds {
@@ -41,21 +53,34 @@ public:
     int add_plane(std::string id, Vector position, Vector speed);
     int getPlaneCount() { return planes_.size(); }
 
+    void setQueryMode(RadarQueryMode mode);
+    RadarQueryMode getQueryMode() const { return queryMode_; }
+
+    // Only valid from the radar thread
+    const RadarFrameStats& getFrameStats() const { return encoder_.getStats(); }
+
 private:
     static void* threadFunc(void* arg);
     void run();
-    void update_planes();
-    int remove_plane(std::string id);
+    void update_planes(uint64_t tick);
+    int remove_plane(uint32_t handle);
     bool query_plane(const PlaneConnection& conn, PlaneResponseMsg& responseMsg);
+    bool read_plane(const PlaneConnection& conn, PlaneResponseMsg& responseMsg);
 private :
     std::vector<Plane*> planes_;
-    std::vector<PlaneConnection> planeConnections_;
+    std::vector<PlaneConnection> planeConnections_; // Same order as planes_
+    HandleIndex connectionIndex_;                   // handle -> position in planeConnections_
     pthread_t thread_;
     bool running_;
     std::mutex mtx;
     std::mutex planeMtx;
     int computerSystemCoid_;
+    RadarFrameEncoder encoder_;
+    uint64_t lastSweepTick_;     // SimClock tick of the previous sweep, 0 before the first
+    int clockId_;                // SimClock participant, SENSORS phase
     const Bounds radarBounds{};  // Using default initialization with constants
+    PlaneStateTable stateTable_;
+    std::atomic<RadarQueryMode> queryMode_;
 };
 
 #endif // RADAR_H
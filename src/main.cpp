@@ -14,11 +14,145 @@
 #include <sstream>
 #include "Logger.h"
 #include "Console.h"
+#include "Benchmark.h"
+#include "SimulationEngine.h"
+#include "SimClock.h"
+#include <cstdlib>
 
 
 void read_planes(Radar&);
 
-int main() {
+int main(int argc, char* argv[]) {
+	// --speed <factor|max> runs the simulation clock N times real time or as fast as possible,
+	// --duration <seconds> stops after that much simulated time,
+	// --broad-phase <incremental|grid|sweep|sliced|brute> picks how the checker finds candidate pairs,
+	// --cross-check repeats every full check with brute force and logs any difference,
+	// --validate-incremental runs the incremental check, repeats it in full and logs any difference,
+	// --max-acceleration <units/s^2> lets the incremental check keep pairs of gently turning aircraft,
+	// --no-alert-tracking alerts and corrects every reported conflict on every frame,
+	// --workers <n> sets the number of threads sharing a separation check,
+	// --radar-query <shared|message> picks how the radar samples aircraft state,
+	// --log-overflow <block|drop|count> picks what a thread does when its log buffer is full,
+	// --binary-log <file> records log events undecoded, --decode-log <file> prints such a file,
+	// --log-tag <tag>=<debug|info|warning|error|off> sets the levels logged for one tag
+	SimClock::Mode clockMode = SimClock::Mode::REALTIME;
+	double speedup = 1.0;
+	double duration = 0.0;
+	bool incremental = false;
+	bool crossCheck = false;
+	bool validateIncremental = false;
+	double maxAcceleration = 0.0;
+	bool alertTracking = true;
+	long workers = 0;
+	RadarQueryMode radarQuery = RadarQueryMode::SHARED_MEMORY;
+	BroadPhase broadPhase = BroadPhase::SPATIAL_GRID;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--benchmark") {
+			int status = runDetectionBenchmark();
+			return status != 0 ? status : runLoggingBenchmark();
+		} else if (arg == "--speed" && i + 1 < argc) {
+			std::string value = argv[++i];
+			if (value == "max") {
+				clockMode = SimClock::Mode::AS_FAST_AS_POSSIBLE;
+			} else {
+				speedup = std::atof(value.c_str());
+				clockMode = speedup == 1.0 ? SimClock::Mode::REALTIME : SimClock::Mode::ACCELERATED;
+			}
+		} else if (arg == "--duration" && i + 1 < argc) {
+			duration = std::atof(argv[++i]);
+		} else if (arg == "--broad-phase" && i + 1 < argc) {
+			std::string value = argv[++i];
+			incremental = value == "incremental";
+			if (value == "grid") {
+				broadPhase = BroadPhase::SPATIAL_GRID;
+			} else if (value == "sweep") {
+				broadPhase = BroadPhase::SWEEP_AND_PRUNE;
+			} else if (value == "sliced") {
+				broadPhase = BroadPhase::TIME_SLICED;
+			} else if (value == "brute") {
+				broadPhase = BroadPhase::BRUTE_FORCE;
+			} else if (!incremental) {
+				std::cerr << "Unknown broad phase " << value << "\n";
+				return -1;
+			}
+		} else if (arg == "--workers" && i + 1 < argc) {
+			workers = std::atol(argv[++i]);
+			if (workers < 1) {
+				std::cerr << "Expected a worker count of 1 or more\n";
+				return -1;
+			}
+		} else if (arg == "--radar-query" && i + 1 < argc) {
+			std::string value = argv[++i];
+			if (value == "shared") {
+				radarQuery = RadarQueryMode::SHARED_MEMORY;
+			} else if (value == "message") {
+				radarQuery = RadarQueryMode::MESSAGE_PASSING;
+			} else {
+				std::cerr << "Unknown radar query mode " << value << "\n";
+				return -1;
+			}
+		} else if (arg == "--max-acceleration" && i + 1 < argc) {
+			maxAcceleration = std::atof(argv[++i]);
+			if (maxAcceleration < 0.0) {
+				std::cerr << "Expected a non-negative acceleration\n";
+				return -1;
+			}
+		} else if (arg == "--no-alert-tracking") {
+			alertTracking = false;
+		} else if (arg == "--validate-incremental") {
+			validateIncremental = true;
+		} else if (arg == "--cross-check") {
+			crossCheck = true;
+		} else if (arg == "--decode-log" && i + 1 < argc) {
+			return decodeLogFile(argv[++i]) == Status::OK ? 0 : -1;
+		} else if (arg == "--binary-log" && i + 1 < argc) {
+			if (Logger::getInstance().openBinaryLog(argv[++i]) != Status::OK) {
+				return -1;
+			}
+		} else if (arg == "--log-tag" && i + 1 < argc) {
+			std::string value = argv[++i];
+			size_t separator = value.find('=');
+			std::string level = separator == std::string::npos ? "" : value.substr(separator + 1);
+			Logger::Level minimum;
+			if (level == "debug") {
+				minimum = Logger::Level::DEBUG;
+			} else if (level == "info") {
+				minimum = Logger::Level::INFO;
+			} else if (level == "warning") {
+				minimum = Logger::Level::WARNING;
+			} else if (level == "error") {
+				minimum = Logger::Level::ERROR;
+			} else if (level == "off") {
+				minimum = Logger::Level::COUNT;
+			} else {
+				std::cerr << "Expected --log-tag <tag>=<debug|info|warning|error|off>, got " << value << "\n";
+				return -1;
+			}
+			if (Logger::getInstance().setTagLevel(value.substr(0, separator), minimum) != Status::OK) {
+				std::cerr << "Too many log tags\n";
+				return -1;
+			}
+		} else if (arg == "--log-overflow" && i + 1 < argc) {
+			std::string value = argv[++i];
+			if (value == "block") {
+				Logger::getInstance().setOverflowPolicy(Logger::OverflowPolicy::BLOCK);
+			} else if (value == "drop") {
+				Logger::getInstance().setOverflowPolicy(Logger::OverflowPolicy::DROP);
+			} else if (value == "count") {
+				Logger::getInstance().setOverflowPolicy(Logger::OverflowPolicy::COUNT);
+			} else {
+				std::cerr << "Unknown log overflow policy " << value << "\n";
+				return -1;
+			}
+		} else {
+			std::cerr << "Unknown option " << arg << "\n";
+			return -1;
+		}
+	}
+	SimClock& simClock = SimClock::getInstance();
+	simClock.configure(clockMode, speedup);
+
 	auto & logger = Logger::getInstance();
 	logger.enable(Logger::Level::DEBUG);
 	std::string tag = "Main";
@@ -27,6 +161,15 @@ int main() {
 
     // Create ComputerSystem
     ComputerSystem computerSystem;
+    computerSystem.setIncrementalDetection(incremental || validateIncremental);
+    computerSystem.setBroadPhase(broadPhase);
+    computerSystem.setBroadPhaseCrossCheck(crossCheck);
+    computerSystem.setIncrementalValidation(validateIncremental);
+    computerSystem.setMaxAcceleration(maxAcceleration);
+    computerSystem.setAlertTracking(alertTracking);
+    if (workers > 0) {
+        computerSystem.setWorkerCount(workers);
+    }
     computerSystem.start();
 
     // Get the channel IDs for Radar and OperatorConsole
@@ -57,6 +200,9 @@ int main() {
 
     // Create Radar and connect to ComputerSystem
     Radar radar(computerSystemRadarCoid);
+    if (radarQuery != RadarQueryMode::SHARED_MEMORY) {
+        radar.setQueryMode(radarQuery);
+    }
     read_planes(radar);
     radar.start();
 
@@ -64,17 +210,30 @@ int main() {
     DataDisplay dataDisplay(computerSystemDataDisplayCoid);
     dataDisplay.start();
 
-    while(true){};
+    // Everything is attached, start ticking
+    simClock.start();
+    if (duration > 0.0) {
+        simClock.waitUntil(duration);
+    } else {
+        while(true){};
+    }
+    simClock.stop();
+    std::cout << "Simulated " << simClock.now() << "s, state digest "
+              << SimulationEngine::getInstance().stateDigest() << "\n";
+
     ConnectDetach(computerSystemRadarCoid);
     ConnectDetach(computerSystemDataDisplayCoid);
     ConnectDetach(computerSystemOperatorCoid);
 
 //    // Stop all systems
     radar.stop();
+    SimulationEngine::getInstance().stop();
     dataDisplay.stop();
     computerSystem.stop();
 
     LOG_INFO("Main", "PROGRAM DONE!");
+    // Write out whatever the logger still buffers
+    Logger::getInstance().shutdown();
 
     return 0;
 }
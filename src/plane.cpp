@@ -1,214 +1,110 @@
 // plane.cpp
 #include "plane.h"
-#include "messages.h"
-#include <cstdio>
-#include <cstdlib>
-#include <sys/netmgr.h>
-#include <sys/neutrino.h>
-#include <iostream>
-#include <unistd.h>
-#include <cstring>
+#include "AircraftIdTable.h"
+#include "SimulationEngine.h"
+#include "SimClock.h"
 #include "Logger.h"
 
-Plane::Plane() : running_(false), dt(1.0) {
-    pthread_mutex_init(&mutex_, nullptr);
-    chid_ = ChannelCreate(0);
-    if (chid_ == -1) {
-      LOG_ERROR("Plane", "Failed to create channel for the plane");
-        exit(EXIT_FAILURE);
-    }
-    chid_comp_ = ChannelCreate(0);
-        if (chid_comp_ == -1) {
-            LOG_ERROR("Plane", "Failed to create channel");
-            exit(EXIT_FAILURE);
-        }
+Plane::Plane() : handle_(AircraftIdTable::INVALID_HANDLE), running_(false), dt(SimClock::getInstance().getTimestep()) {
 }
 
 Plane::Plane(
     std::string _id,
     Vector position,
-    Vector velocity) : id(_id), position(position), velocity(velocity), running_(false), dt(1.0){
-    pthread_mutex_init(&mutex_, nullptr);
-    chid_ = ChannelCreate(0);
-    if (chid_ == -1) {
-        LOG_ERROR("Plane", "Failed to create channel");
-        exit(EXIT_FAILURE);
-    }
-
-    chid_comp_ = ChannelCreate(0);
-    if (chid_comp_ == -1) {
-        LOG_ERROR("Plane", "Failed to create channel");
-        exit(EXIT_FAILURE);
-    }
+    Vector velocity) : id(_id), position(position), velocity(velocity), running_(false), dt(SimClock::getInstance().getTimestep()) {
+    handle_ = AircraftIdTable::getInstance().intern(id);
 }
 
 Plane::~Plane() {
     stop();
-    pthread_mutex_destroy(&mutex_);
 }
 
 void Plane::start() {
-    running_ = true;
-    int ret = pthread_create(&thread_, nullptr, Plane::threadFunc, this);
-    if (ret != 0) {
-        LOG_ERROR("Plane", "Failed to create position thread");
-        exit(EXIT_FAILURE);
+    if (running_) {
+        return;
     }
-
-    // Start the message handling thread
-    ret = pthread_create(&msg_thread_, nullptr, Plane::msgThreadFunc, this);
-    if (ret != 0) {
-        LOG_ERROR("Plane", "Failed to create message thread");
-        exit(EXIT_FAILURE);
+    SimulationEngine& engine = SimulationEngine::getInstance();
+    engine.start();
+    if (!engine.add(handle_, position, velocity)) {
+        LOG_ERROR("Plane", "Plane " + id + " is already simulated");
+        return;
     }
-
-    //start the course correction thread. Used for collision avoidance.
-    ret = pthread_create(&course_currect_thread_, nullptr, Plane::courseCorrectThreadFunc, this);
-        if (ret != 0) {
-            perror("Plane: Failed to create course correction thread");
-            exit(EXIT_FAILURE);
-        }
+    running_ = true;
     LOG_INFO("Plane",
                  "Plane started with id: " + id
-                + " thread id: " + std::to_string(thread_)
-                + " message thread id: " + std::to_string(msg_thread_)
-                + " course correction thread id: " + std::to_string(course_currect_thread_)
-                + " channel id: " + std::to_string(chid_)
-                + " channel id1: " + std::to_string(chid_comp_));
-
+                + " handle: " + std::to_string(handle_)
+                + " channel id: " + std::to_string(engine.getQueryChannelId())
+                + " channel id1: " + std::to_string(engine.getCorrectionChannelId()));
 }
+
 Vector Plane::get_pos() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return position;
+    Vector pos = position, speed = velocity;
+    if (running_) {
+        SimulationEngine::getInstance().getState(handle_, pos, speed);
+    }
+    return pos;
 }
 
 Vector Plane::get_speed() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return velocity;
+    Vector pos = position, speed = velocity;
+    if (running_) {
+        SimulationEngine::getInstance().getState(handle_, pos, speed);
+    }
+    return speed;
 }
 
-std::string Plane::get_id() const {
+const std::string& Plane::get_id() const {
     return id;
 }
 
+uint32_t Plane::get_handle() const {
+    return handle_;
+}
+
 void Plane::set_velocity(Vector speed) {
-    std::lock_guard<std::mutex> lock(mtx);
-    velocity = speed;
+    if (!running_) {
+        velocity = speed;
+        return;
+    }
+    SimulationEngine::getInstance().setVelocity(handle_, speed);
 }
 
 void Plane::set_pos(Vector position) {
-    std::lock_guard<std::mutex> lock(mtx);
-    this->position = position;
+    if (!running_) {
+        this->position = position;
+        return;
+    }
+    SimulationEngine::getInstance().setPosition(handle_, position);
 }
 
-Vector Plane::update_position() {//test
-  {
-    std::lock_guard<std::mutex> lock(mtx);
-    position.x += velocity.x * dt;
-    position.y += velocity.y * dt;
-    position.z += velocity.z * dt;
-  }
-    LOG_INFO("Plane", "Plane " + id + " updated position to (" + std::to_string(position.x) + ", "
-             + std::to_string(position.y) + ", " + std::to_string(position.z) + ")");
-    return position;
+void Plane::setStateSlot(PlaneStateTable* table, int slot) {
+    SimulationEngine::getInstance().setStateSlot(handle_, table, slot);
 }
 
+Vector Plane::update_position() {
+    if (!running_) {
+        position.x += velocity.x * dt;
+        position.y += velocity.y * dt;
+        position.z += velocity.z * dt;
+        return position;
+    }
+    return SimulationEngine::getInstance().advance(handle_, dt);
+}
 
 void Plane::stop() {
     if (running_) {
         running_ = false;
-        ChannelDestroy(chid_);
-        ChannelDestroy(chid_comp_);
-        pthread_join(thread_, nullptr);
-        pthread_join(msg_thread_, nullptr);
-        pthread_join(course_currect_thread_, nullptr);
+        // Keep the last known state for callers that still hold the plane
+        SimulationEngine::getInstance().getState(handle_, position, velocity);
+        SimulationEngine::getInstance().remove(handle_);
     }
     LOG_INFO("Plane", "Plane stopped with id: " + id);
 }
 
-
-void* Plane::threadFunc(void* arg) {
-    Plane* self = static_cast<Plane*>(arg);
-    while (self->running_) {
-        self->update_position();
-        sleep(1);
-    }
-    return nullptr;
-}
-
-void* Plane::msgThreadFunc(void* arg) {
-    Plane* self = static_cast<Plane*>(arg);
-    self->messageLoop();
-    return nullptr;
-}
-
-void* Plane::courseCorrectThreadFunc(void* arg) {
-    Plane* self = static_cast<Plane*>(arg);
-    self->courseCorrectLoop();
-    return nullptr;
-}
-
-
-void Plane::messageLoop() {
-    int rcvid;
-    RadarQueryMsg queryMsg;
-
-    while (running_) {
-        rcvid = MsgReceive(chid_, &queryMsg, sizeof(queryMsg), NULL);
-
-        if (rcvid == -1) {
-            if (errno == EINTR) {
-//                 LOG_ERROR("Plane", "MsgReceive failed" + std::to_string(errno));
-                continue;
-            } else {
-//                 LOG_ERROR("Plane", "MsgReceive failed" + std::to_string(errno));
-                 continue;
-            }
-        } else if (rcvid > 0) {
-            PlaneResponseMsg responseMsg;
-            {
-                std::lock_guard<std::mutex> lock(mtx);
-                strncpy(responseMsg.data.id, id.c_str(), sizeof(responseMsg.data.id));
-                responseMsg.data.id[sizeof(responseMsg.data.id) - 1] = '\0';
-                responseMsg.data.x = position.x;
-                responseMsg.data.y = position.y;
-                responseMsg.data.z = position.z;
-                responseMsg.data.speedX = velocity.x;
-                responseMsg.data.speedY = velocity.y;
-                responseMsg.data.speedZ = velocity.z;
-            }
-            MsgReply(rcvid, EOK, &responseMsg, sizeof(responseMsg));
-        }
-    }
-}
-
 int Plane::getChannelId() const {
-    return chid_;
+    return SimulationEngine::getInstance().getQueryChannelId();
 }
 
 int Plane::getChannelIdComp() const {
-    return chid_comp_;
-}
-
-void Plane::courseCorrectLoop() {
-	int rcvid;
-	courseCorrectionMsg msg;
-	while(running_) {
-		rcvid = MsgReceive(chid_comp_, &msg, sizeof(msg), NULL);
-		if (rcvid == -1) {
-			if (errno == EINTR) {
-				continue;
-		    } else {
-		    	perror("Plane: Failed to receive course correction");
-		        break;
-		    }
-		}
-		else if (rcvid > 0) {
-			 MsgReply(rcvid, EOK, nullptr, 0);
-			 LOG_WARNING("Plane", "" + id + "Received Course Correction alert");
-			std::cout << "Plane " << id << " Received Course Correction alert.\n";
-			set_velocity(msg.newVelocity);
-		}
-	}
+    return SimulationEngine::getInstance().getCorrectionChannelId();
 }
-
@@ -7,9 +7,22 @@
 #include <unistd.h>
 #include <cstring>
 #include "Logger.h"
+#include "SimClock.h"
 
 Radar::Radar(int computerSystemCoid)
-    : running_(false), computerSystemCoid_(computerSystemCoid) {
+    : running_(false), computerSystemCoid_(computerSystemCoid), lastSweepTick_(0), clockId_(-1), queryMode_(RadarQueryMode::SHARED_MEMORY) {
+    if (!stateTable_.isValid()) {
+        LOG_WARNING("Radar", "Shared state table unavailable, falling back to message passing");
+        queryMode_ = RadarQueryMode::MESSAGE_PASSING;
+    }
+}
+
+void Radar::setQueryMode(RadarQueryMode mode) {
+    if (mode == RadarQueryMode::SHARED_MEMORY && !stateTable_.isValid()) {
+        LOG_ERROR("Radar", "Shared state table unavailable");
+        return;
+    }
+    queryMode_ = mode;
 }
 
 Radar::~Radar() {
@@ -18,6 +31,7 @@ Radar::~Radar() {
 
 void Radar::start() {
     running_ = true;
+    clockId_ = SimClock::getInstance().attach(SimClock::SENSORS);
     int ret = pthread_create(&thread_, nullptr, Radar::threadFunc, this);
     if (ret != 0) {
         perror("Radar: Failed to create thread");
@@ -30,6 +44,7 @@ void Radar::start() {
 void Radar::stop() {
     if (running_) {
         running_ = false;
+        SimClock::getInstance().detach(clockId_);
         pthread_join(thread_, nullptr);
 
         // Clean up connections and planes
@@ -37,10 +52,12 @@ void Radar::stop() {
         for (const auto& conn : planeConnections_) {
             ConnectDetach(conn.coid);
             conn.plane->stop();
+            stateTable_.release(conn.slot);
             delete conn.plane;
         }
         planeConnections_.clear();
         planes_.clear();
+        connectionIndex_.clear();
     }
 }
 
@@ -51,10 +68,12 @@ void* Radar::threadFunc(void* arg) {
 }
 
 void Radar::run() {
-    while (running_) {
-        update_planes();
-        // Delay for 1 second before next update
-        sleep(1);
+    SimClock& clock = SimClock::getInstance();
+    uint64_t tick;
+    // One sweep per simulation tick, after the aircraft have moved
+    while (running_ && clock.awaitTick(clockId_, tick)) {
+        update_planes(tick);
+        clock.complete(clockId_);
     }
 }
 
@@ -72,71 +91,81 @@ int Radar::add_plane(std::string id, Vector position, Vector velocity) {
         return -1;
     }
 
+    // Planes that do not get a slot are still sampled by message
+    int slot = stateTable_.acquire(id);
+    if (slot != -1) {
+        plane->setStateSlot(&stateTable_, slot);
+    }
+
     {
         std::lock_guard<std::mutex> lock(planeMtx);
+        uint32_t handle = AircraftIdTable::getInstance().intern(id);
+        if (connectionIndex_.find(handle) != HandleIndex::NONE) {
+            LOG_ERROR("Radar", "Plane " + id + " is already tracked");
+            plane->stop();
+            ConnectDetach(coid);
+            stateTable_.release(slot);
+            delete plane;
+            return -1;
+        }
+        connectionIndex_.set(handle, static_cast<uint32_t>(planeConnections_.size()));
         planes_.push_back(plane);
-        PlaneConnection conn = { plane, coid, coid_comp };
+        PlaneConnection conn = { plane, coid, coid_comp, slot, handle };
         planeConnections_.push_back(conn);
     }
 
     return 0;
 }
 
-int Radar::remove_plane(std::string id) {
-    Plane *planeToRemove = nullptr;
-    int coidToRemove = -1;
-    {
+int Radar::remove_plane(uint32_t handle) {
     std::lock_guard<std::mutex> lock(mtx);
 
-    // First find the plane in planeConnections_
-    auto connIt = std::find_if(planeConnections_.begin(), planeConnections_.end(),
-        [&id](const PlaneConnection& conn) {
-            return conn.plane->get_id() == id;
-        });
-
-    if (connIt == planeConnections_.end()) {
-        LOG_ERROR("Radar", "Plane " + id + " not found");
+    uint32_t index = connectionIndex_.find(handle);
+    if (index == HandleIndex::NONE) {
+        LOG_ERROR("Radar", "Plane " + AircraftIdTable::getInstance().name(handle) + " not found");
         return -1;
     }
 
-   	// store connection id and plane pointer before removing connection
-    coidToRemove = connIt->coid;
-    planeToRemove = connIt->plane;
+    // store connection id and plane pointer before removing connection
+    PlaneConnection conn = planeConnections_[index];
 
-    // Find and remove from planes_ vector
-    auto planeIt = std::find_if(planes_.begin(), planes_.end(),
-        [&id](const Plane* plane) {
-            return plane->get_id() == id;
-        });
+    // Remove the plane from the simulation
+    conn.plane->stop();
+    ConnectDetach(conn.coid);
+    stateTable_.release(conn.slot);
 
-    if (planeIt == planes_.end()) {
-        LOG_ERROR("Radar", "Plane " + id + " not found");
-        return -1;
+    // planes_ and planeConnections_ share an order; swap with the last entry and pop both
+    size_t last = planeConnections_.size() - 1;
+    if (index != last) {
+        planeConnections_[index] = planeConnections_[last];
+        planes_[index] = planes_[last];
+        connectionIndex_.set(planeConnections_[index].handle, index);
     }
+    planeConnections_.pop_back();
+    planes_.pop_back();
+    connectionIndex_.erase(handle);
 
-    // Stop the plane thread
-    planeToRemove->stop();
-    ConnectDetach(coidToRemove);
-    usleep(10000); // Sleep for 1ms to allow the plane to stop
-
-    // remove plane from planes_ vector and planeConnections_ vector
-   	planeConnections_.erase(connIt);
-    planes_.erase(planeIt);
-
-    delete planeToRemove;
-	return 0;
-    }
+    delete conn.plane;
+    return 0;
 }
 
-void Radar::update_planes() {
-    std::vector<PlaneState> aircraftData;
-    std::vector<std::string> planesToRemove;
+void Radar::update_planes(uint64_t tick) {
+    std::vector<uint32_t> planesToRemove;
 
+    // Simulated time since the last sweep, the receiver integrates positions over it
+    double dt = lastSweepTick_ == 0 ? 0.0
+              : (tick - lastSweepTick_) * SimClock::getInstance().getTimestep();
+    lastSweepTick_ = tick;
+    encoder_.begin(dt);
+
+    bool sharedMemory = queryMode_ == RadarQueryMode::SHARED_MEMORY;
 
     std::lock_guard<std::mutex> lock(planeMtx);
     for (auto& conn : planeConnections_) {
         PlaneResponseMsg responseMsg;
-        if(!query_plane(conn, responseMsg)) {
+        bool ok = (sharedMemory && conn.slot != -1) ? read_plane(conn, responseMsg)
+                                                    : query_plane(conn, responseMsg);
+        if(!ok) {
             LOG_ERROR("Radar", "Failed to query plane " + conn.plane->get_id());
             continue;
         }
@@ -152,17 +181,15 @@ void Radar::update_planes() {
 
 //             check if plane is in bounds
             if (!radarBounds.contains(state.position)) {
-               LOG_WARNING("Radar",
-                "Plane " + std::string(state.id) + " out of bounds at (" +
-                std::to_string(state.position.x) + ", " +
-                std::to_string(state.position.y) + ", " +
-                std::to_string(state.position.z) + ")");
-                planesToRemove.push_back(state.id);
+               LOG_EVENT(WARNING, RADAR_OUT_OF_BOUNDS, state.id,
+                         state.position.x, state.position.y, state.position.z);
+                planesToRemove.push_back(conn.handle);
+                encoder_.remove(conn.handle);
                 continue;
             }
 
             state.coid_comp = conn.coid_comp;
-            aircraftData.push_back(state);
+            encoder_.track(conn.handle, state);
 //        LOG_INFO("Radar", "Plane " + state.id + " is at position (" + std::to_string(state.position.x) + ", " +
 //                 std::to_string(state.position.y) + ", " + std::to_string(state.position.z) + ")");
        }
@@ -170,30 +197,22 @@ void Radar::update_planes() {
 
 
 
-    // Send data to ComputerSystem
-    RadarToComputerMsg radarMsg;
-    radarMsg.numAircraft = aircraftData.size();
-    if (radarMsg.numAircraft < 0) {
-        LOG_ERROR("Radar", "Invalid number of aircraft: " + std::to_string(radarMsg.numAircraft));
-        return;
-    }
-    for (int i = 0; i < radarMsg.numAircraft; ++i) {
-        radarMsg.aircraftData[i] = aircraftData[i];
-    }
-
-    int status = MsgSend(computerSystemCoid_, &radarMsg, sizeof(radarMsg), nullptr, 0);
-    if (status == -1) {
+    // Send only what changed since the previous frame to ComputerSystem
+    if (encoder_.send(computerSystemCoid_) == Status::ERROR) {
         LOG_ERROR("Radar", "Failed to send data to ComputerSystem: " + std::string(strerror(errno)));
     }
-    LOG_INFO("Radar", "Sent " + std::to_string(radarMsg.numAircraft) + " aircraft to ComputerSystem");
+    const RadarFrameStats& stats = encoder_.getStats();
+    LOG_EVENT(INFO, RADAR_FRAME_SENT, encoder_.getTrackedCount(), stats.bytesSent, stats.fullFrameBytes,
+              stats.ratio());
 
-    for (const auto& id : planesToRemove) {
-      remove_plane(id);
+    for (uint32_t handle : planesToRemove) {
+      remove_plane(handle);
   	}
 }
 
 bool Radar::query_plane(const PlaneConnection& conn, PlaneResponseMsg& responseMsg) {
     RadarQueryMsg queryMsg;
+    queryMsg.aircraft_id = static_cast<int>(conn.handle);
     int status = MsgSend(conn.coid, &queryMsg, sizeof(queryMsg), &responseMsg, sizeof(responseMsg));
     if (status == -1) {
         LOG_ERROR("Radar", "MsgSend to Plane " + conn.plane->get_id() + " failed: " + strerror(errno));
@@ -201,3 +220,17 @@ bool Radar::query_plane(const PlaneConnection& conn, PlaneResponseMsg& responseM
     }
     return true;
 }
+
+bool Radar::read_plane(const PlaneConnection& conn, PlaneResponseMsg& responseMsg) {
+    Vector position, velocity;
+    if (!stateTable_.read(conn.slot, responseMsg.data.id, position, velocity)) {
+        return false;
+    }
+    responseMsg.data.x = position.x;
+    responseMsg.data.y = position.y;
+    responseMsg.data.z = position.z;
+    responseMsg.data.speedX = velocity.x;
+    responseMsg.data.speedY = velocity.y;
+    responseMsg.data.speedZ = velocity.z;
+    return true;
+}